@@ -0,0 +1,192 @@
+#pragma once
+#include "pch.h"
+#include <algorithm>
+#include <set>
+
+//Maps address ranges to values, with an O(log n) lookup of all the values whose range contains an address.
+//The ranges are split into sorted, non-overlapping segments (each with the list of values covering it),
+//which are rebuilt whenever a range is added or removed - this is meant for ranges that rarely change
+//but are looked up on every memory access. A page-level presence bitmap rejects most addresses that
+//can't match any range in O(1), before the binary search.
+template<typename T>
+class AddressIntervalIndex
+{
+private:
+	struct Interval
+	{
+		uint32_t Start;
+		uint32_t End;
+		T Value;
+	};
+
+	struct Boundary
+	{
+		uint64_t Address;
+		uint32_t Index;
+		bool IsStart;
+	};
+
+	vector<Interval> _intervals;
+
+	vector<uint32_t> _segmentStarts;
+	vector<uint32_t> _segmentEnds;
+	vector<vector<T>> _segmentValues;
+
+	uint32_t _minAddress = 0;
+	uint32_t _maxAddress = 0;
+
+	//1 bit per page (between _minAddress and _maxAddress), set when any segment overlaps the page.
+	//The page size grows with the covered address range, to keep the bitmap at 8kb or less.
+	static constexpr uint32_t MaxPageCount = 0x10000;
+	vector<uint64_t> _pageBitmap;
+	uint32_t _pageShift = 0;
+
+	void BuildPageBitmap()
+	{
+		_pageShift = 0;
+		while((((uint64_t)_maxAddress - _minAddress) >> _pageShift) >= MaxPageCount) {
+			_pageShift++;
+		}
+
+		uint32_t pageCount = ((_maxAddress - _minAddress) >> _pageShift) + 1;
+		_pageBitmap.assign((pageCount + 63) / 64, 0);
+		for(size_t i = 0; i < _segmentStarts.size(); i++) {
+			uint32_t lastPage = (_segmentEnds[i] - _minAddress) >> _pageShift;
+			for(uint32_t page = (_segmentStarts[i] - _minAddress) >> _pageShift; page <= lastPage; page++) {
+				_pageBitmap[page >> 6] |= (uint64_t)1 << (page & 0x3F);
+			}
+		}
+	}
+
+public:
+	//Rebuilds the segments, only needed after calling Add/Remove with rebuild = false
+	void Rebuild()
+	{
+		_segmentStarts.clear();
+		_segmentEnds.clear();
+		_segmentValues.clear();
+		_pageBitmap.clear();
+
+		if(_intervals.empty()) {
+			return;
+		}
+
+		//Every start and end+1 of an interval is a boundary between 2 segments - sort them once and sweep
+		//through them, keeping track of the intervals that cover the current segment (O(n log n))
+		vector<Boundary> boundaries;
+		boundaries.reserve(_intervals.size() * 2);
+		_minAddress = _intervals[0].Start;
+		_maxAddress = _intervals[0].End;
+		for(uint32_t i = 0; i < (uint32_t)_intervals.size(); i++) {
+			Interval& interval = _intervals[i];
+			boundaries.push_back({ interval.Start, i, true });
+			boundaries.push_back({ (uint64_t)interval.End + 1, i, false });
+			_minAddress = std::min(_minAddress, interval.Start);
+			_maxAddress = std::max(_maxAddress, interval.End);
+		}
+		std::sort(boundaries.begin(), boundaries.end(), [](const Boundary& a, const Boundary& b) { return a.Address < b.Address; });
+
+		//Indexes of the intervals covering the current segment, sorted to keep the values in the order they were added
+		std::set<uint32_t> activeIntervals;
+		size_t i = 0;
+		while(i < boundaries.size()) {
+			uint64_t address = boundaries[i].Address;
+			for(; i < boundaries.size() && boundaries[i].Address == address; i++) {
+				if(boundaries[i].IsStart) {
+					activeIntervals.insert(boundaries[i].Index);
+				} else {
+					activeIntervals.erase(boundaries[i].Index);
+				}
+			}
+
+			if(activeIntervals.empty()) {
+				continue;
+			}
+
+			//The last boundary always ends an interval, so there is always a next boundary here
+			uint32_t start = (uint32_t)address;
+			uint32_t end = (uint32_t)(boundaries[i].Address - 1);
+
+			vector<T> values;
+			values.reserve(activeIntervals.size());
+			for(uint32_t index : activeIntervals) {
+				values.push_back(_intervals[index].Value);
+			}
+
+			if(!_segmentEnds.empty() && _segmentEnds.back() + 1 == start && _segmentValues.back() == values) {
+				//Merge with the previous segment when it contains the same values
+				_segmentEnds.back() = end;
+			} else {
+				_segmentStarts.push_back(start);
+				_segmentEnds.push_back(end);
+				_segmentValues.push_back(std::move(values));
+			}
+		}
+
+		BuildPageBitmap();
+	}
+
+	void Add(uint32_t start, uint32_t end, const T& value, bool rebuild = true)
+	{
+		if(end < start) {
+			return;
+		}
+
+		_intervals.push_back({ start, end, value });
+		if(rebuild) {
+			Rebuild();
+		}
+	}
+
+	bool Remove(uint32_t start, uint32_t end, const T& value, bool rebuild = true)
+	{
+		for(auto it = _intervals.begin(); it != _intervals.end(); it++) {
+			if(it->Start == start && it->End == end && it->Value == value) {
+				_intervals.erase(it);
+				if(rebuild) {
+					Rebuild();
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Clear()
+	{
+		_intervals.clear();
+		Rebuild();
+	}
+
+	__forceinline bool IsEmpty()
+	{
+		return _segmentStarts.empty();
+	}
+
+	//Returns the values (in the order they were added) whose range contains the address, or nullptr if there are none
+	__forceinline const vector<T>* Find(uint32_t address)
+	{
+		if(_segmentStarts.empty() || address < _minAddress || address > _maxAddress) {
+			return nullptr;
+		}
+
+		uint32_t page = (address - _minAddress) >> _pageShift;
+		if(!(_pageBitmap[page >> 6] & ((uint64_t)1 << (page & 0x3F)))) {
+			return nullptr;
+		}
+
+		size_t index = std::upper_bound(_segmentStarts.begin(), _segmentStarts.end(), address) - _segmentStarts.begin();
+		if(index == 0 || address > _segmentEnds[index - 1]) {
+			return nullptr;
+		}
+		return &_segmentValues[index - 1];
+	}
+
+	template<typename Func>
+	void ForEachValue(Func func)
+	{
+		for(Interval& interval : _intervals) {
+			func(interval.Value);
+		}
+	}
+};
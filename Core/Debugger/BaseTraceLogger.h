@@ -114,6 +114,13 @@ struct TraceLogPpuState
 	uint32_t FrameCount;
 };
 
+//Effective address & memory value recorded in binary trace logs (the memory's content can't be read when decoding the log)
+struct TraceLogMemoryInfo
+{
+	EffectiveAddressInfo EffectiveAddress;
+	uint16_t MemoryValue;
+};
+
 struct RowPart
 {
 	RowDataType DataType;
@@ -127,6 +134,7 @@ class BaseTraceLogger : public ITraceLogger
 {
 protected:
 	static constexpr int ExecutionLogSize = 30000;
+	static constexpr uint32_t BinaryRowSize = sizeof(CpuStateType) + sizeof(TraceLogPpuState) + sizeof(DisassemblyInfo) + sizeof(TraceLogMemoryInfo);
 
 	TraceLoggerOptions _options;
 	IConsole* _console;
@@ -139,6 +147,8 @@ protected:
 	MemoryType _cpuMemoryType = MemoryType::SnesMemory;
 
 	vector<RowPart> _rowParts;
+	bool _logMemoryInfo = false;
+	TraceLogMemoryInfo* _decodedMemoryInfo = nullptr;
 
 	uint32_t _currentPos = 0;
 
@@ -185,7 +195,7 @@ protected:
 	
 	void WriteEffectiveAddress(DisassemblyInfo& info, RowPart& rowPart, void* cpuState, string& output, MemoryType cpuMemoryType, CpuType cpuType)
 	{
-		EffectiveAddressInfo effectiveAddress = info.GetEffectiveAddress(_debugger, cpuState, cpuType);
+		EffectiveAddressInfo effectiveAddress = _decodedMemoryInfo ? _decodedMemoryInfo->EffectiveAddress : info.GetEffectiveAddress(_debugger, cpuState, cpuType);
 		if(effectiveAddress.ShowAddress && effectiveAddress.Address.Address >= 0) {
 			MemoryType effectiveMemType = effectiveAddress.Address.Type == MemoryType::None ? cpuMemoryType : effectiveAddress.Address.Type;
 			if(_options.UseLabels) {
@@ -203,10 +213,10 @@ protected:
 
 	void WriteMemoryValue(DisassemblyInfo& info, RowPart& rowPart, void* cpuState, string& output, MemoryType memType, CpuType cpuType)
 	{
-		EffectiveAddressInfo effectiveAddress = info.GetEffectiveAddress(_debugger, cpuState, cpuType);
+		EffectiveAddressInfo effectiveAddress = _decodedMemoryInfo ? _decodedMemoryInfo->EffectiveAddress : info.GetEffectiveAddress(_debugger, cpuState, cpuType);
 		if(effectiveAddress.Address.Address >= 0 && effectiveAddress.ValueSize > 0) {
 			MemoryType effectiveMemType = effectiveAddress.Address.Type == MemoryType::None ? memType : effectiveAddress.Address.Type;
-			uint16_t value = info.GetMemoryValue(effectiveAddress, _memoryDumper, effectiveMemType);
+			uint16_t value = _decodedMemoryInfo ? _decodedMemoryInfo->MemoryValue : info.GetMemoryValue(effectiveAddress, _memoryDumper, effectiveMemType);
 			if(rowPart.DisplayInHex) {
 				output += "= $";
 				if(effectiveAddress.ValueSize == 2) {
@@ -278,7 +288,10 @@ protected:
 
 		_pendingLog = false;
 
-		if(_debugger->GetTraceLogFileSaver()->IsEnabled()) {
+		TraceLogFileSaver* fileSaver = _debugger->GetTraceLogFileSaver();
+		if(fileSaver->IsEnabled() && fileSaver->IsBinaryMode()) {
+			LogBinaryRow(fileSaver, cpuState, disassemblyInfo);
+		} else if(fileSaver->IsEnabled()) {
 			string row;
 			row.reserve(300);
 			
@@ -296,6 +309,27 @@ protected:
 		_currentPos = (_currentPos + 1) % ExecutionLogSize;
 	}
 
+	void LogBinaryRow(TraceLogFileSaver* fileSaver, CpuStateType& cpuState, DisassemblyInfo& disassemblyInfo)
+	{
+		TraceLogMemoryInfo memInfo = {};
+		if(_logMemoryInfo) {
+			memInfo.EffectiveAddress = disassemblyInfo.GetEffectiveAddress(_debugger, &cpuState, _cpuType);
+			if(memInfo.EffectiveAddress.Address.Address >= 0 && memInfo.EffectiveAddress.ValueSize > 0) {
+				MemoryType memType = memInfo.EffectiveAddress.Address.Type == MemoryType::None ? _cpuMemoryType : memInfo.EffectiveAddress.Address.Type;
+				memInfo.MemoryValue = disassemblyInfo.GetMemoryValue(memInfo.EffectiveAddress, _memoryDumper, memType);
+			}
+		}
+
+		uint8_t* row = fileSaver->ReserveBinaryRow(_cpuType, BinaryRowSize);
+		memcpy(row, &cpuState, sizeof(CpuStateType));
+		row += sizeof(CpuStateType);
+		memcpy(row, &_ppuState[_currentPos], sizeof(TraceLogPpuState));
+		row += sizeof(TraceLogPpuState);
+		memcpy(row, &disassemblyInfo, sizeof(DisassemblyInfo));
+		row += sizeof(DisassemblyInfo);
+		memcpy(row, &memInfo, sizeof(TraceLogMemoryInfo));
+	}
+
 	void ParseFormatString(string format)
 	{
 		_rowParts.clear();
@@ -332,6 +366,10 @@ protected:
 				_rowParts.push_back(part);
 			}
 		}
+
+		_logMemoryInfo = std::any_of(_rowParts.begin(), _rowParts.end(), [](RowPart& part) {
+			return part.DataType == RowDataType::EffectiveAddress || part.DataType == RowDataType::MemoryValue;
+		});
 	}
 
 	RowDataType InternalGetFormatTagType(string& tag)
@@ -385,6 +423,21 @@ protected:
 		}
 	}
 
+	//Only copies what's needed to format rows (see CreateBinaryRowDecoder), the copy can't log rows
+	BaseTraceLogger(const BaseTraceLogger& src)
+	{
+		_debugger = src._debugger;
+		_console = src._console;
+		_settings = src._settings;
+		_labelManager = src._labelManager;
+		_memoryDumper = src._memoryDumper;
+		_cpuType = src._cpuType;
+		_cpuMemoryType = src._cpuMemoryType;
+		_options = src._options;
+		_rowParts = src._rowParts;
+		_logMemoryInfo = src._logMemoryInfo;
+	}
+
 public:
 	BaseTraceLogger(Debugger* debugger, IDebugger* cpuDebugger, CpuType cpuType)
 	{
@@ -520,4 +573,45 @@ public:
 		memcpy(row.LogOutput, logOutput.c_str(), row.LogSize);
 		row.LogOutput[row.LogSize] = 0;
 	}
+
+	uint16_t GetBinaryRowSize() override
+	{
+		return BinaryRowSize;
+	}
+
+	unique_ptr<ITraceLogger> CreateBinaryRowDecoder() override
+	{
+		return unique_ptr<ITraceLogger>(new TraceLoggerType(*(TraceLoggerType*)this));
+	}
+
+	bool FormatBinaryRow(uint8_t* rowData, uint16_t rowSize, string& output) override
+	{
+		if(rowSize != BinaryRowSize) {
+			return false;
+		}
+
+		CpuStateType cpuState = {};
+		TraceLogPpuState ppuState = {};
+		DisassemblyInfo disassemblyInfo;
+		TraceLogMemoryInfo memInfo = {};
+		memcpy(&cpuState, rowData, sizeof(CpuStateType));
+		rowData += sizeof(CpuStateType);
+		memcpy(&ppuState, rowData, sizeof(TraceLogPpuState));
+		rowData += sizeof(TraceLogPpuState);
+		memcpy(&disassemblyInfo, rowData, sizeof(DisassemblyInfo));
+		rowData += sizeof(DisassemblyInfo);
+		memcpy(&memInfo, rowData, sizeof(TraceLogMemoryInfo));
+
+		//Same format as the text trace log files
+		RowPart rowPart = {};
+		rowPart.DisplayInHex = true;
+		rowPart.MinWidth = DebugUtilities::GetProgramCounterSize(_cpuType);
+		WriteIntValue(output, ((TraceLoggerType*)this)->GetProgramCounter(cpuState), rowPart);
+		output += "  ";
+
+		_decodedMemoryInfo = &memInfo;
+		((TraceLoggerType*)this)->GetTraceRow(output, cpuState, ppuState, disassemblyInfo);
+		_decodedMemoryInfo = nullptr;
+		return true;
+	}
 };
@@ -25,6 +25,9 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 		_breakpoints[i].clear();
 		_rpnList[i].clear();
 		_hasBreakpointType[i] = false;
+		for(int j = 0; j < DebugUtilities::GetMemoryTypeCount(); j++) {
+			_breakpointIndex[i][j].reset();
+		}
 	}
 
 	_bpExpEval.reset(new ExpressionEvaluator(_debugger, _cpuDebugger, _cpuType));
@@ -40,22 +43,38 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 				}
 
 				if(bp.IsAllowedForOpType(opType)) {
+					if(bp.GetEndAddress() >= 0) {
+						unique_ptr<AddressIntervalIndex<uint32_t>>& index = _breakpointIndex[i][(int)bp.GetMemoryType()];
+						if(!index) {
+							index.reset(new AddressIntervalIndex<uint32_t>());
+						}
+						index->Add((uint32_t)std::max(bp.GetStartAddress(), 0), (uint32_t)bp.GetEndAddress(), (uint32_t)_breakpoints[i].size(), false);
+					}
+
 					_breakpoints[i].push_back(bp);
-				}
 
-				if(bp.HasCondition()) {
-					bool success = true;
-					ExpressionData data = _bpExpEval->GetRpnList(bp.GetCondition(), success);
-					_rpnList[i].push_back(success ? data : ExpressionData());
-				} else {
-					_rpnList[i].push_back(ExpressionData());
+					if(bp.HasCondition()) {
+						bool success = true;
+						ExpressionData data = _bpExpEval->GetRpnList(bp.GetCondition(), success);
+						_rpnList[i].push_back(success ? data : ExpressionData());
+					} else {
+						_rpnList[i].push_back(ExpressionData());
+					}
 				}
-				
+
 				_hasBreakpoint = true;
 				_hasBreakpointType[i] = true;
 			}
 		}
 	}
+
+	for(int i = 0; i < BreakpointManager::BreakpointTypeCount; i++) {
+		for(int j = 0; j < DebugUtilities::GetMemoryTypeCount(); j++) {
+			if(_breakpointIndex[i][j]) {
+				_breakpointIndex[i][j]->Rebuild();
+			}
+		}
+	}
 }
 
 BreakpointType BreakpointManager::GetBreakpointType(MemoryOperationType type)
@@ -83,20 +102,49 @@ BreakpointType BreakpointManager::GetBreakpointType(MemoryOperationType type)
 
 int BreakpointManager::InternalCheckBreakpoint(MemoryOperationInfo operationInfo, AddressInfo &address, bool processMarkedBreakpoints)
 {
+	int type = (int)operationInfo.Type;
+
+	//Find the breakpoints that match the relative address (for breakpoints on the CPU's memory type)
+	//and the ones that match the absolute address - this is equivalent to calling Breakpoint::Matches
+	//on each breakpoint, without having to look at the breakpoints that can't match.
+	const vector<uint32_t>* relMatches = nullptr;
+	const vector<uint32_t>* absMatches = nullptr;
+	bool isRelative = DebugUtilities::IsRelativeMemory(operationInfo.MemType);
+	if(isRelative && _breakpointIndex[type][(int)operationInfo.MemType]) {
+		relMatches = _breakpointIndex[type][(int)operationInfo.MemType]->Find(operationInfo.Address);
+	}
+	if(address.Address >= 0 && (address.Type != operationInfo.MemType || !isRelative) && _breakpointIndex[type][(int)address.Type]) {
+		absMatches = _breakpointIndex[type][(int)address.Type]->Find((uint32_t)address.Address);
+	}
+
+	if(!relMatches && !absMatches) {
+		return -1;
+	}
+
+	//Process the matches in the same order as the breakpoints were set (both lists are sorted)
 	EvalResultType resultType;
-	vector<Breakpoint> &breakpoints = _breakpoints[(int)operationInfo.Type];
-	for(size_t i = 0, len = breakpoints.size(); i < len; i++) {
-		if(breakpoints[i].Matches(operationInfo, address)) {
-			if(breakpoints[i].HasCondition() && !_bpExpEval->Evaluate(_rpnList[(int)operationInfo.Type][i], resultType, operationInfo, address)) {
-				continue;
-			}
+	vector<Breakpoint> &breakpoints = _breakpoints[type];
+	size_t relCount = relMatches ? relMatches->size() : 0;
+	size_t absCount = absMatches ? absMatches->size() : 0;
+	size_t r = 0;
+	size_t a = 0;
+	while(r < relCount || a < absCount) {
+		uint32_t i;
+		if(a >= absCount || (r < relCount && (*relMatches)[r] < (*absMatches)[a])) {
+			i = (*relMatches)[r++];
+		} else {
+			i = (*absMatches)[a++];
+		}
 
-			if(breakpoints[i].IsMarked() && processMarkedBreakpoints) {
-				_eventManager->AddEvent(DebugEventType::Breakpoint, operationInfo, breakpoints[i].GetId());
-			}
-			if(breakpoints[i].IsEnabled()) {
-				return breakpoints[i].GetId();
-			}
+		if(breakpoints[i].HasCondition() && !_bpExpEval->Evaluate(_rpnList[type][i], resultType, operationInfo, address)) {
+			continue;
+		}
+
+		if(breakpoints[i].IsMarked() && processMarkedBreakpoints) {
+			_eventManager->AddEvent(DebugEventType::Breakpoint, operationInfo, breakpoints[i].GetId());
+		}
+		if(breakpoints[i].IsEnabled()) {
+			return breakpoints[i].GetId();
 		}
 	}
 
@@ -3,6 +3,7 @@
 #include "Debugger/Breakpoint.h"
 #include "Debugger/DebugTypes.h"
 #include "Debugger/DebugUtilities.h"
+#include "Debugger/AddressIntervalIndex.h"
 
 class ExpressionEvaluator;
 class Debugger;
@@ -26,6 +27,9 @@ private:
 	bool _hasBreakpoint;
 	bool _hasBreakpointType[BreakpointTypeCount] = {};
 
+	//Indexes of the breakpoints in _breakpoints, by memory type and address range
+	unique_ptr<AddressIntervalIndex<uint32_t>> _breakpointIndex[BreakpointTypeCount][DebugUtilities::GetMemoryTypeCount()];
+
 	unique_ptr<ExpressionEvaluator> _bpExpEval;
 
 	BreakpointType GetBreakpointType(MemoryOperationType type);
@@ -103,6 +103,7 @@ Debugger::Debugger(Emulator* emu, IConsole* console)
 
 	_breakRequestCount = 0;
 	_suspendRequestCount = 0;
+	_scriptHostMode = _emu->IsScriptHostMode();
 
 	_cdlManager->RefreshCodeCache();
 
@@ -187,6 +188,11 @@ template<CpuType type>
 void Debugger::ProcessInstruction()
 {
 	IDebugger* debugger = _debuggers[(int)type].Debugger.get();
+	if(_scriptHostMode) {
+		ProcessScriptHostInstruction<type>(debugger);
+		return;
+	}
+
 	if(debugger->IsStepBack() && ProcessStepBack(debugger)) {
 		debugger->AllowChangeProgramCounter = true; //set to true temporarily to allow debugger to pause on break requests when rewinding/step back is active
 		SleepOnBreakRequest<type>();
@@ -220,9 +226,36 @@ void Debugger::ProcessInstruction()
 	}
 }
 
+template<CpuType type>
+void Debugger::ProcessScriptHostInstruction(IDebugger* debugger)
+{
+	if(_breakRequestCount) {
+		//Break requests (e.g from DebugBreakHelper) still need to pause the main cpu in-between 2 instructions
+		debugger->AllowChangeProgramCounter = true;
+		SleepOnBreakRequest<type>();
+		debugger->AllowChangeProgramCounter = false;
+	}
+
+	if(_scriptManager->HasCpuMemoryCallbacks()) {
+		//The cpu debugger doesn't run in this mode, so LastMemOperation isn't updated - read the opcode directly
+		uint32_t pc = debugger->GetProgramCounter(false);
+		constexpr MemoryType memType = DebugUtilities::GetCpuMemoryType(type);
+		AddressInfo relAddr = { (int32_t)pc, memType };
+		uint8_t value = _memoryDumper->GetMemoryValue(memType, pc);
+		_scriptManager->ProcessMemoryOperation(relAddr, value, MemoryOperationType::ExecOpCode, type, true);
+	}
+}
+
 template<CpuType type, MemoryAccessFlags flags, typename T>
 void Debugger::ProcessMemoryRead(uint32_t addr, T& value, MemoryOperationType opType)
 {
+	if(_scriptHostMode) {
+		if(_scriptManager->HasCpuMemoryCallbacks()) {
+			ProcessScripts<type>(addr, value, DebugUtilities::GetCpuMemoryType(type), opType);
+		}
+		return;
+	}
+
 	if(_debuggers[(int)type].Debugger->IsStepBack()) {
 		SleepOnBreakRequest<type>();
 		return;
@@ -249,6 +282,13 @@ void Debugger::ProcessMemoryRead(uint32_t addr, T& value, MemoryOperationType op
 template<CpuType type, MemoryAccessFlags flags, typename T>
 bool Debugger::ProcessMemoryWrite(uint32_t addr, T& value, MemoryOperationType opType)
 {
+	if(_scriptHostMode) {
+		if(_scriptManager->HasCpuMemoryCallbacks()) {
+			ProcessScripts<type>(addr, value, DebugUtilities::GetCpuMemoryType(type), opType);
+		}
+		return true;
+	}
+
 	if(_debuggers[(int)type].Debugger->IsStepBack()) {
 		SleepOnBreakRequest<type>();
 		return true;
@@ -279,7 +319,7 @@ void Debugger::ProcessMemoryAccess(uint32_t addr, T& value)
 {
 	IDebugger* debugger = _debuggers[(int)cpuType].Debugger.get();
 
-	if(debugger->IsStepBack()) {
+	if(_scriptHostMode || debugger->IsStepBack()) {
 		return;
 	}
 
@@ -303,6 +343,10 @@ void Debugger::ProcessMemoryAccess(uint32_t addr, T& value)
 template<CpuType type>
 void Debugger::ProcessIdleCycle()
 {
+	if(_scriptHostMode) {
+		return;
+	}
+
 	if(_debuggers[(int)type].Debugger->IsStepBack()) {
 		SleepOnBreakRequest<type>();
 		return;
@@ -320,6 +364,14 @@ template<CpuType type>
 void Debugger::ProcessHaltedCpu()
 {
 	IDebugger* dbg = _debuggers[(int)type].Debugger.get();
+	if(_scriptHostMode) {
+		if(_breakRequestCount) {
+			dbg->AllowChangeProgramCounter = true;
+			SleepOnBreakRequest<type>();
+			dbg->AllowChangeProgramCounter = false;
+		}
+		return;
+	}
 
 	//Set AllowChangeProgramCounter to allow SleepUntilResume to break properly
 	dbg->AllowChangeProgramCounter = true;
@@ -349,6 +401,13 @@ void Debugger::SleepOnBreakRequest()
 template<CpuType type, typename T>
 void Debugger::ProcessPpuRead(uint16_t addr, T& value, MemoryType memoryType, MemoryOperationType opType)
 {
+	if(_scriptHostMode) {
+		if(_scriptManager->HasPpuMemoryCallbacks()) {
+			ProcessScripts<type>(addr, value, memoryType, opType);
+		}
+		return;
+	}
+
 	if(_debuggers[(int)type].Debugger->IsStepBack()) {
 		return;
 	}
@@ -370,6 +429,13 @@ void Debugger::ProcessPpuRead(uint16_t addr, T& value, MemoryType memoryType, Me
 template<CpuType type, typename T>
 void Debugger::ProcessPpuWrite(uint16_t addr, T& value, MemoryType memoryType)
 {
+	if(_scriptHostMode) {
+		if(_scriptManager->HasPpuMemoryCallbacks()) {
+			ProcessScripts<type>(addr, value, memoryType, MemoryOperationType::Write);
+		}
+		return;
+	}
+
 	if(_debuggers[(int)type].Debugger->IsStepBack()) {
 		return;
 	}
@@ -391,7 +457,7 @@ void Debugger::ProcessPpuWrite(uint16_t addr, T& value, MemoryType memoryType)
 template<CpuType type>
 void Debugger::ProcessPpuCycle()
 {
-	if(_debuggers[(int)type].Debugger->IsStepBack()) {
+	if(_scriptHostMode || _debuggers[(int)type].Debugger->IsStepBack()) {
 		return;
 	}
 
@@ -483,6 +549,11 @@ void Debugger::ProcessPredictiveBreakpoint(CpuType sourceCpu, BreakpointManager*
 template<CpuType type>
 void Debugger::ProcessInterrupt(uint32_t originalPc, uint32_t currentPc, bool forNmi)
 {
+	if(_scriptHostMode) {
+		ProcessEvent(forNmi ? EventType::Nmi : EventType::Irq, type);
+		return;
+	}
+
 	if(_debuggers[(int)type].Debugger->IsStepBack()) {
 		return;
 	}
@@ -511,6 +582,10 @@ void Debugger::ProcessEvent(EventType type, std::optional<CpuType> cpuTypeOpt)
 			break;
 
 		case EventType::StartFrame: {
+			if(_scriptHostMode) {
+				//The event viewer isn't updated in script host mode
+				break;
+			}
 			_emu->GetNotificationManager()->SendNotification(ConsoleNotificationType::EventViewerRefresh, (void*)evtCpuType);
 			BaseEventManager* evtMgr = GetEventManager(evtCpuType);
 			if(evtMgr) {
@@ -1014,6 +1089,73 @@ uint32_t Debugger::GetExecutionTrace(TraceRow output[], uint32_t startOffset, ui
 	return count;
 }
 
+void Debugger::StartBinaryTraceLog(string filename, uint64_t maxFileSize)
+{
+	//Break to make sure the emulation thread isn't logging rows while the logger is reset
+	DebugBreakHelper helper(this);
+
+	uint16_t rowSizes[BinaryTraceFileHeader::MaxCpuTypes] = {};
+	for(int i = 0; i <= (int)DebugUtilities::GetLastCpuType(); i++) {
+		ITraceLogger* logger = GetTraceLogger((CpuType)i);
+		rowSizes[i] = logger ? logger->GetBinaryRowSize() : 0;
+	}
+	_traceLogSaver->StartBinaryLogging(filename, maxFileSize, (uint32_t)_consoleType, rowSizes);
+}
+
+void Debugger::StopTraceLog()
+{
+	DebugBreakHelper helper(this);
+	_traceLogSaver->StopLogging();
+}
+
+bool Debugger::DecodeBinaryTraceLog(string inputFile, string outputFile)
+{
+	//Rows are raw structs, only files logged with the same console type & row layouts can be decoded
+	BinaryTraceFileHeader header = {};
+	if(!TraceLogFileSaver::ReadBinaryLogHeader(inputFile, header) || header.ConsoleType != (uint32_t)_consoleType) {
+		return false;
+	}
+
+	//Rows are formatted using a copy of each trace logger's current options (format, labels, etc.)
+	//Only break while the copies are made, the decoding itself runs while the emulation continues
+	unique_ptr<ITraceLogger> decoders[BinaryTraceFileHeader::MaxCpuTypes];
+	{
+		DebugBreakHelper helper(this);
+		for(int i = 0; i < BinaryTraceFileHeader::MaxCpuTypes; i++) {
+			ITraceLogger* logger = i <= (int)DebugUtilities::GetLastCpuType() ? GetTraceLogger((CpuType)i) : nullptr;
+			if(header.RowSizes[i] == 0) {
+				continue;
+			} else if(!logger || logger->GetBinaryRowSize() != header.RowSizes[i]) {
+				return false;
+			}
+			decoders[i] = logger->CreateBinaryRowDecoder();
+		}
+	}
+
+	ofstream output(outputFile, ios::out | ios::binary);
+	if(!output) {
+		return false;
+	}
+
+	string buffer;
+	bool result = TraceLogFileSaver::ReadBinaryLog(inputFile, [&](CpuType cpuType, uint8_t* rowData, uint16_t rowSize) {
+		ITraceLogger* decoder = (int)cpuType < BinaryTraceFileHeader::MaxCpuTypes ? decoders[(int)cpuType].get() : nullptr;
+		size_t startPos = buffer.size();
+		if(decoder && decoder->FormatBinaryRow(rowData, rowSize, buffer)) {
+			buffer += '\n';
+		} else {
+			buffer.resize(startPos);
+		}
+
+		if(buffer.size() > 32768) {
+			output << buffer;
+			buffer.clear();
+		}
+	});
+	output << buffer;
+	return result;
+}
+
 PpuTools* Debugger::GetPpuTools(CpuType cpuType)
 {
 	if(_debuggers[(int)cpuType].Debugger) {
@@ -82,6 +82,9 @@ private:
 	atomic<uint32_t> _breakRequestCount;
 	atomic<uint32_t> _suspendRequestCount;
 
+	//When set, only the script callbacks are processed (no cpu debuggers, breakpoints, access counters, etc.)
+	atomic<bool> _scriptHostMode;
+
 	DebugControllerState _inputOverrides[8] = {};
 
 	bool _waitForBreakResume = false;
@@ -89,6 +92,7 @@ private:
 	void Reset();
 
 	__noinline bool ProcessStepBack(IDebugger* debugger);
+	template<CpuType type> void ProcessScriptHostInstruction(IDebugger* debugger);
 
 	template<CpuType type, typename DebuggerType> DebuggerType* GetDebugger();
 	template<CpuType type> uint64_t GetCpuCycleCount();
@@ -137,6 +141,9 @@ public:
 	void ResetSuspendCounter();
 	void SuspendDebugger(bool release);
 
+	void SetScriptHostMode(bool enabled) { _scriptHostMode = enabled; }
+	bool IsScriptHostMode() { return _scriptHostMode; }
+
 	__noinline void BreakImmediately(CpuType sourceCpu, BreakSource source);
 
 	void ProcessPredictiveBreakpoint(CpuType sourceCpu, BreakpointManager* bpManager, MemoryOperationInfo& operation, AddressInfo& addressInfo);
@@ -174,6 +181,10 @@ public:
 
 	void ClearExecutionTrace();
 	uint32_t GetExecutionTrace(TraceRow output[], uint32_t startOffset, uint32_t maxLineCount);
+
+	void StartBinaryTraceLog(string filename, uint64_t maxFileSize);
+	void StopTraceLog();
+	bool DecodeBinaryTraceLog(string inputFile, string outputFile);
 	
 	CpuType GetMainCpuType() { return _mainCpuType; }
 
@@ -355,6 +355,207 @@ bool ExpressionEvaluator::ToRpn(string expression, ExpressionData &data)
 	return true;
 }
 
+bool ExpressionEvaluator::GetLabelValue(ExpressionData& data, int64_t labelIndex, int64_t& value, EvalResultType& resultType)
+{
+	if((size_t)labelIndex < data.Labels.size()) {
+		value = _labelManager->GetLabelRelativeAddress(data.Labels[(uint32_t)labelIndex], _cpuType);
+		if(value < -1) {
+			//Label doesn't exist, try to find a matching multi-byte label
+			string label = data.Labels[(uint32_t)labelIndex] + "+0";
+			value = _labelManager->GetLabelRelativeAddress(label, _cpuType);
+		}
+	} else {
+		value = -2;
+	}
+
+	if(value < 0) {
+		//Label is no longer valid
+		resultType = value == -1 ? EvalResultType::OutOfScope : EvalResultType::Invalid;
+		return false;
+	}
+	return true;
+}
+
+static __forceinline int64_t ApplyOperator(EvalOpCode op, int64_t left, int64_t right, EvalResultType& resultType)
+{
+	resultType = EvalResultType::Numeric;
+	switch(op) {
+		case EvalOpCode::Multiplication: return left * right;
+		case EvalOpCode::Division:
+			if(right == 0) {
+				resultType = EvalResultType::DivideBy0;
+				return 0;
+			}
+			return left / right;
+		case EvalOpCode::Modulo:
+			if(right == 0) {
+				resultType = EvalResultType::DivideBy0;
+				return 0;
+			}
+			return left % right;
+		case EvalOpCode::Addition: return left + right;
+		case EvalOpCode::Substration: return left - right;
+		case EvalOpCode::ShiftLeft: return left << right;
+		case EvalOpCode::ShiftRight: return left >> right;
+		case EvalOpCode::SmallerThan: resultType = EvalResultType::Boolean; return left < right;
+		case EvalOpCode::SmallerOrEqual: resultType = EvalResultType::Boolean; return left <= right;
+		case EvalOpCode::GreaterThan: resultType = EvalResultType::Boolean; return left > right;
+		case EvalOpCode::GreaterOrEqual: resultType = EvalResultType::Boolean; return left >= right;
+		case EvalOpCode::Equal: resultType = EvalResultType::Boolean; return left == right;
+		case EvalOpCode::NotEqual: resultType = EvalResultType::Boolean; return left != right;
+		case EvalOpCode::BinaryAnd: return left & right;
+		case EvalOpCode::BinaryXor: return left ^ right;
+		case EvalOpCode::BinaryOr: return left | right;
+		case EvalOpCode::LogicalAnd: resultType = EvalResultType::Boolean; return (bool)(left && right);
+		case EvalOpCode::LogicalOr: resultType = EvalResultType::Boolean; return (bool)(left || right);
+
+		case EvalOpCode::Plus: return right;
+		case EvalOpCode::Minus: return -right;
+		case EvalOpCode::BinaryNot: return ~right;
+		case EvalOpCode::LogicalNot: return (bool)!right;
+		default: return 0;
+	}
+}
+
+void ExpressionEvaluator::Compile(ExpressionData& data)
+{
+	//Converts the RPN list to a list of instructions that can be executed without any token lookups:
+	//special values and CPU-specific tokens are resolved here, and operators that only use constants are
+	//folded into a constant. Expressions that the interpreter would reject at runtime are not compiled.
+	vector<EvalInstruction> program;
+	int depth = 0;
+	auto isConstant = [&](size_t i) { return program[i].Op <= EvalOpCode::PushBoolean; };
+
+	for(int64_t token : data.RpnQueue) {
+		if(token >= EvalValues::RegA) {
+			EvalInstruction inst = { EvalOpCode::Push, 0 };
+			if(token >= EvalValues::FirstLabelIndex) {
+				inst = { EvalOpCode::Label, token - EvalValues::FirstLabelIndex };
+			} else {
+				switch(token) {
+					case EvalValues::Value: inst.Op = EvalOpCode::Value; break;
+					case EvalValues::Address: inst.Op = EvalOpCode::Address; break;
+					case EvalValues::MemoryAddress: inst.Op = EvalOpCode::MemoryAddress; break;
+					case EvalValues::IsWrite: inst.Op = EvalOpCode::IsWrite; break;
+					case EvalValues::IsRead: inst.Op = EvalOpCode::IsRead; break;
+					case EvalValues::IsDma: inst.Op = EvalOpCode::IsDma; break;
+					case EvalValues::IsDummy: inst.Op = EvalOpCode::IsDummy; break;
+					case EvalValues::OpProgramCounter: inst.Op = EvalOpCode::OpProgramCounter; break;
+					default:
+						if(_getTokenValue) {
+							inst = { EvalOpCode::CpuToken, token };
+						}
+						break;
+				}
+			}
+			program.push_back(inst);
+			depth++;
+		} else if(token >= EvalOperators::Multiplication) {
+			EvalOpCode op;
+			bool isBinary = token <= EvalOperators::LogicalOr;
+			if(isBinary) {
+				op = (EvalOpCode)((int)EvalOpCode::Multiplication + (token - EvalOperators::Multiplication));
+			} else if(token >= EvalOperators::Plus && token <= EvalOperators::AbsoluteAddress) {
+				op = (EvalOpCode)((int)EvalOpCode::Plus + (token - EvalOperators::Plus));
+			} else if(token == EvalOperators::Bracket || token == EvalOperators::Braces) {
+				op = token == EvalOperators::Bracket ? EvalOpCode::Bracket : EvalOpCode::Braces;
+			} else {
+				return;
+			}
+
+			if(depth < (isBinary ? 2 : 1)) {
+				return;
+			}
+
+			bool canFold = op < EvalOpCode::AbsoluteAddress && isConstant(program.size() - 1) && (!isBinary || isConstant(program.size() - 2));
+			if(canFold) {
+				EvalResultType resultType;
+				int64_t right = program.back().Value;
+				int64_t left = isBinary ? program[program.size() - 2].Value : 0;
+				int64_t value = ApplyOperator(op, left, right, resultType);
+				if(resultType != EvalResultType::DivideBy0) {
+					program.resize(program.size() - (isBinary ? 2 : 1));
+					program.push_back({ resultType == EvalResultType::Boolean ? EvalOpCode::PushBoolean : EvalOpCode::PushNumeric, value });
+					depth -= isBinary ? 1 : 0;
+					continue;
+				}
+			}
+
+			program.push_back({ op, 0 });
+			depth -= isBinary ? 1 : 0;
+		} else {
+			program.push_back({ EvalOpCode::Push, token });
+			depth++;
+		}
+
+		if(depth >= 100) {
+			return;
+		}
+	}
+
+	data.Program = std::move(program);
+}
+
+int32_t ExpressionEvaluator::RunProgram(ExpressionData& data, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo)
+{
+	//The stack's depth was validated when compiling the program
+	int64_t stack[100];
+	int pos = 0;
+	resultType = EvalResultType::Numeric;
+
+	for(EvalInstruction& inst : data.Program) {
+		switch(inst.Op) {
+			case EvalOpCode::Push: stack[pos++] = inst.Value; break;
+			case EvalOpCode::PushNumeric: stack[pos++] = inst.Value; resultType = EvalResultType::Numeric; break;
+			case EvalOpCode::PushBoolean: stack[pos++] = inst.Value; resultType = EvalResultType::Boolean; break;
+
+			case EvalOpCode::Label:
+				if(!GetLabelValue(data, inst.Value, stack[pos++], resultType)) {
+					return 0;
+				}
+				break;
+
+			case EvalOpCode::CpuToken: stack[pos++] = (this->*_getTokenValue)(inst.Value, resultType); break;
+			case EvalOpCode::Value: stack[pos++] = operationInfo.Value; break;
+			case EvalOpCode::Address: stack[pos++] = operationInfo.Address; break;
+			case EvalOpCode::MemoryAddress: stack[pos++] = addressInfo.Address; break;
+			case EvalOpCode::IsWrite: stack[pos++] = operationInfo.Type == MemoryOperationType::Write || operationInfo.Type == MemoryOperationType::DmaWrite || operationInfo.Type == MemoryOperationType::DummyWrite; break;
+			case EvalOpCode::IsRead: stack[pos++] = operationInfo.Type != MemoryOperationType::Write && operationInfo.Type != MemoryOperationType::DmaWrite && operationInfo.Type != MemoryOperationType::DummyWrite; break;
+			case EvalOpCode::IsDma: stack[pos++] = operationInfo.Type == MemoryOperationType::DmaRead || operationInfo.Type == MemoryOperationType::DmaWrite; break;
+			case EvalOpCode::IsDummy: stack[pos++] = operationInfo.Type == MemoryOperationType::DummyRead || operationInfo.Type == MemoryOperationType::DummyWrite; break;
+			case EvalOpCode::OpProgramCounter: stack[pos++] = _cpuDebugger->GetProgramCounter(true); break;
+
+			case EvalOpCode::AbsoluteAddress:
+				resultType = EvalResultType::Numeric;
+				stack[pos - 1] = stack[pos - 1] >= 0 ? _debugger->GetAbsoluteAddress({ (int32_t)stack[pos - 1], _cpuMemory }).Address : -1;
+				break;
+
+			case EvalOpCode::Bracket:
+				resultType = EvalResultType::Numeric;
+				stack[pos - 1] = _debugger->GetMemoryDumper()->GetMemoryValue(_cpuMemory, (uint32_t)stack[pos - 1]);
+				break;
+
+			case EvalOpCode::Braces:
+				resultType = EvalResultType::Numeric;
+				stack[pos - 1] = _debugger->GetMemoryDumper()->GetMemoryValueWord(_cpuMemory, (uint32_t)stack[pos - 1]);
+				break;
+
+			default:
+				if(inst.Op >= EvalOpCode::Plus) {
+					stack[pos - 1] = ApplyOperator(inst.Op, 0, stack[pos - 1], resultType);
+				} else {
+					pos--;
+					stack[pos - 1] = ApplyOperator(inst.Op, stack[pos - 1], stack[pos], resultType);
+					if(resultType == EvalResultType::DivideBy0) {
+						return 0;
+					}
+				}
+				break;
+		}
+	}
+	return (int32_t)stack[0];
+}
+
 int32_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo)
 {
 	if(data.RpnQueue.empty()) {
@@ -362,6 +563,10 @@ int32_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 		return 0;
 	}
 
+	if(!data.Program.empty()) {
+		return RunProgram(data, resultType, operationInfo, addressInfo);
+	}
+
 	int pos = 0;
 	int64_t right = 0;
 	int64_t left = 0;
@@ -374,20 +579,7 @@ int32_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 		if(token >= EvalValues::RegA) {
 			//Replace value with a special value
 			if(token >= EvalValues::FirstLabelIndex) {
-				int64_t labelIndex = token - EvalValues::FirstLabelIndex;
-				if((size_t)labelIndex < data.Labels.size()) {
-					token = _labelManager->GetLabelRelativeAddress(data.Labels[(uint32_t)labelIndex], _cpuType);
-					if(token < -1) {
-						//Label doesn't exist, try to find a matching multi-byte label
-						string label = data.Labels[(uint32_t)labelIndex] + "+0";
-						token = _labelManager->GetLabelRelativeAddress(label, _cpuType);
-					}
-				} else {
-					token = -2;
-				}
-				if(token < 0) {
-					//Label is no longer valid
-					resultType = token == -1 ? EvalResultType::OutOfScope : EvalResultType::Invalid;
+				if(!GetLabelValue(data, token - EvalValues::FirstLabelIndex, token, resultType)) {
 					return 0;
 				}
 			} else {
@@ -402,22 +594,7 @@ int32_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 					case EvalValues::OpProgramCounter: token = _cpuDebugger->GetProgramCounter(true); break;
 
 					default:
-						if(!_cpuDebugger) {
-							token = 0;
-						} else {
-							switch(_cpuType) {
-								case CpuType::Snes: token = GetSnesTokenValue(token, resultType); break;
-								case CpuType::Spc: token = GetSpcTokenValue(token, resultType); break;
-								case CpuType::NecDsp: token = GetNecDspTokenValue(token, resultType); break;
-								case CpuType::Sa1: token = GetSnesTokenValue(token, resultType); break;
-								case CpuType::Gsu: token = GetGsuTokenValue(token, resultType); break;
-								case CpuType::Cx4: token = GetCx4TokenValue(token, resultType); break;
-								case CpuType::Gameboy: token = GetGameboyTokenValue(token, resultType); break;
-								case CpuType::Nes: token = GetNesTokenValue(token, resultType); break;
-								case CpuType::Pce: token = GetPceTokenValue(token, resultType); break;
-								case CpuType::Sms: token = GetSmsTokenValue(token, resultType); break;
-							}
-						}
+						token = _getTokenValue ? (this->*_getTokenValue)(token, resultType) : 0;
 						break;
 				}
 			}
@@ -493,6 +670,21 @@ ExpressionEvaluator::ExpressionEvaluator(Debugger* debugger, IDebugger* cpuDebug
 	_labelManager = debugger->GetLabelManager();
 	_cpuType = cpuType;
 	_cpuMemory = DebugUtilities::GetCpuMemoryType(cpuType);
+
+	if(_cpuDebugger) {
+		switch(_cpuType) {
+			case CpuType::Snes: _getTokenValue = &ExpressionEvaluator::GetSnesTokenValue; break;
+			case CpuType::Spc: _getTokenValue = &ExpressionEvaluator::GetSpcTokenValue; break;
+			case CpuType::NecDsp: _getTokenValue = &ExpressionEvaluator::GetNecDspTokenValue; break;
+			case CpuType::Sa1: _getTokenValue = &ExpressionEvaluator::GetSnesTokenValue; break;
+			case CpuType::Gsu: _getTokenValue = &ExpressionEvaluator::GetGsuTokenValue; break;
+			case CpuType::Cx4: _getTokenValue = &ExpressionEvaluator::GetCx4TokenValue; break;
+			case CpuType::Gameboy: _getTokenValue = &ExpressionEvaluator::GetGameboyTokenValue; break;
+			case CpuType::Nes: _getTokenValue = &ExpressionEvaluator::GetNesTokenValue; break;
+			case CpuType::Pce: _getTokenValue = &ExpressionEvaluator::GetPceTokenValue; break;
+			case CpuType::Sms: _getTokenValue = &ExpressionEvaluator::GetSmsTokenValue; break;
+		}
+	}
 }
 
 bool ExpressionEvaluator::ReturnBool(int64_t value, EvalResultType& resultType)
@@ -559,6 +751,8 @@ ExpressionData* ExpressionEvaluator::PrivateGetRpnList(string expression, bool&
 		ExpressionData data;
 		success = ToRpn(fixedExp, data);
 		if(success) {
+			Compile(data);
+
 			LockHandler lock = _cacheLock.AcquireSafe();
 			_cache[expression] = data;
 			cachedData = &_cache[expression];
@@ -196,10 +196,66 @@ public:
 	}
 };
 
+//Instructions of a compiled expression (see ExpressionEvaluator::Compile)
+enum class EvalOpCode : uint8_t
+{
+	Push, //Constant, doesn't change the result type
+	PushNumeric, //Constant folded from numeric operators
+	PushBoolean, //Constant folded from boolean operators
+	Label,
+	CpuToken,
+	Value,
+	Address,
+	MemoryAddress,
+	IsWrite,
+	IsRead,
+	IsDma,
+	IsDummy,
+	OpProgramCounter,
+
+	//Same order as EvalOperators
+	Multiplication,
+	Division,
+	Modulo,
+	Addition,
+	Substration,
+	ShiftLeft,
+	ShiftRight,
+	SmallerThan,
+	SmallerOrEqual,
+	GreaterThan,
+	GreaterOrEqual,
+	Equal,
+	NotEqual,
+	BinaryAnd,
+	BinaryXor,
+	BinaryOr,
+	LogicalAnd,
+	LogicalOr,
+
+	Plus,
+	Minus,
+	BinaryNot,
+	LogicalNot,
+	AbsoluteAddress,
+
+	Bracket,
+	Braces
+};
+
+struct EvalInstruction
+{
+	EvalOpCode Op;
+	int64_t Value;
+};
+
 struct ExpressionData
 {
 	vector<int64_t> RpnQueue;
 	vector<string> Labels;
+
+	//RpnQueue compiled to a stack program (empty if the expression couldn't be compiled, the RPN list is interpreted instead)
+	vector<EvalInstruction> Program;
 };
 
 class ExpressionEvaluator
@@ -219,6 +275,7 @@ private:
 	LabelManager* _labelManager;
 	CpuType _cpuType;
 	MemoryType _cpuMemory;
+	int64_t (ExpressionEvaluator::*_getTokenValue)(int64_t token, EvalResultType& resultType) = nullptr;
 
 	bool IsOperator(string token, int &precedence, bool unaryOperator);
 	EvalOperators GetOperator(string token, bool unaryOperator);
@@ -253,12 +310,15 @@ private:
 	int64_t GetSmsTokenValue(int64_t token, EvalResultType& resultType);
 
 	bool ReturnBool(int64_t value, EvalResultType& resultType);
+	bool GetLabelValue(ExpressionData& data, int64_t labelIndex, int64_t& value, EvalResultType& resultType);
 
 	int64_t ProcessSharedTokens(string token);
 	
 	string GetNextToken(string expression, size_t &pos, ExpressionData &data, bool &success, bool previousTokenIsOp);
 	bool ProcessSpecialOperator(EvalOperators evalOp, std::stack<EvalOperators> &opStack, std::stack<int> &precedenceStack, vector<int64_t> &outputQueue);
 	bool ToRpn(string expression, ExpressionData &data);
+	void Compile(ExpressionData& data);
+	int32_t RunProgram(ExpressionData& data, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo);
 	int32_t PrivateEvaluate(string expression, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo, bool &success);
 	ExpressionData* PrivateGetRpnList(string expression, bool& success);
 
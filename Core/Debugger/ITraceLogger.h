@@ -34,5 +34,12 @@ public:
 	virtual void Clear() = 0;
 	virtual void SetOptions(TraceLoggerOptions options) = 0;
 
+	//Converts a row from a binary trace log file to text
+	virtual bool FormatBinaryRow(uint8_t* rowData, uint16_t rowSize, string& output) = 0;
+	virtual uint16_t GetBinaryRowSize() = 0;
+
+	//Returns a copy of the logger's format options that can convert binary rows to text while the emulation is running
+	virtual unique_ptr<ITraceLogger> CreateBinaryRowDecoder() = 0;
+
 	__forceinline bool IsEnabled() { return _enabled; }
 };
@@ -5,7 +5,9 @@
 #include "Debugger/Debugger.h"
 #include "Debugger/MemoryDumper.h"
 #include "Debugger/DebugTypes.h"
+#include "Debugger/LabelManager.h"
 #include "Shared/Interfaces/IConsole.h"
+#include "Utilities/HexUtilities.h"
 
 static constexpr int32_t ResetFunctionIndex = -1;
 
@@ -13,6 +15,7 @@ Profiler::Profiler(Debugger* debugger, IConsole* console)
 {
 	_debugger = debugger;
 	_console = console;
+	ClearSamples();
 	InternalReset();
 }
 
@@ -24,6 +27,21 @@ void Profiler::StackFunction(AddressInfo &addr, StackFrameFlags stackFlag)
 {
 	if(addr.Address >= 0) {
 		uint32_t key = addr.Address | ((uint8_t)addr.Type << 24);
+
+		if(_samplingEnabled) {
+			//Skip the exact cycle counting, only keep track of the call stack
+			UpdateSamples();
+			_functionStack.push_back(_currentFunction);
+			_stackNodeStack.push_back(_currentStackNode);
+			if(_functionStack.size() > 100) {
+				_functionStack.pop_front();
+				_stackNodeStack.pop_front();
+			}
+			_currentFunction = key;
+			_currentStackNode = GetStackNode(_currentStackNode, key);
+			return;
+		}
+
 		if(_functions.find(key) == _functions.end()) {
 			_functions[key] = ProfiledFunction();
 			_functions[key].Address = addr;
@@ -75,6 +93,17 @@ void Profiler::UpdateCycles()
 
 void Profiler::UnstackFunction()
 {
+	if(_samplingEnabled) {
+		if(!_functionStack.empty()) {
+			UpdateSamples();
+			_currentFunction = _functionStack.back();
+			_functionStack.pop_back();
+			_currentStackNode = _stackNodeStack.back();
+			_stackNodeStack.pop_back();
+		}
+		return;
+	}
+
 	if(!_functionStack.empty()) {
 		UpdateCycles();
 
@@ -96,17 +125,27 @@ void Profiler::UnstackFunction()
 void Profiler::Reset()
 {
 	DebugBreakHelper helper(_debugger);
+	ClearSamples();
 	InternalReset();
 }
 
 void Profiler::ResetState()
 {
+	if(_samplingEnabled) {
+		//Count the samples taken since the last call/return before the call stack is cleared
+		UpdateSamples();
+	}
+
 	_prevMasterClock = _console->GetMasterClock();
 	_currentCycleCount = 0;
 	_functionStack.clear();
 	_stackFlags.clear();
 	_cycleCountStack.clear();
 	_currentFunction = ResetFunctionIndex;
+
+	_stackNodeStack.clear();
+	_currentStackNode = 0;
+	_nextSampleClock = _prevMasterClock + _sampleInterval;
 }
 
 void Profiler::InternalReset()
@@ -122,7 +161,9 @@ void Profiler::GetProfilerData(ProfiledFunction* profilerData, uint32_t& functio
 {
 	DebugBreakHelper helper(_debugger);
 	
-	UpdateCycles();
+	if(!_samplingEnabled) {
+		UpdateCycles();
+	}
 
 	functionCount = 0;
 	for(auto& func : _functions) {
@@ -134,3 +175,141 @@ void Profiler::GetProfilerData(ProfiledFunction* profilerData, uint32_t& functio
 		}
 	}
 }
+
+void Profiler::StartSampling(uint32_t sampleInterval, uint32_t maxSamples)
+{
+	DebugBreakHelper helper(_debugger);
+
+	//The exact data is not updated while sampling, so start both modes from a clean state
+	_samples.assign(std::max<uint32_t>(maxSamples, 1), {});
+	_sampleInterval = std::max<uint32_t>(sampleInterval, 1);
+	_samplingEnabled = true;
+	ClearSamples();
+	InternalReset();
+}
+
+void Profiler::StopSampling()
+{
+	DebugBreakHelper helper(_debugger);
+	UpdateSamples();
+	_samplingEnabled = false;
+
+	//The samples are kept until the profiler is reset or sampling is restarted, so they can still be exported
+	InternalReset();
+}
+
+void Profiler::ClearSamples()
+{
+	_stackNodes.clear();
+	_stackNodeLookup.clear();
+	_stackNodes.push_back({ 0, ResetFunctionIndex });
+	_samplePos = 0;
+	_samplesWrapped = false;
+
+	//The previous call stack's nodes no longer exist, start counting samples from the root node
+	_currentStackNode = 0;
+	_nextSampleClock = _console->GetMasterClock() + _sampleInterval;
+}
+
+uint32_t Profiler::GetStackNode(uint32_t parent, int32_t function)
+{
+	uint64_t key = ((uint64_t)parent << 32) | (uint32_t)function;
+	auto result = _stackNodeLookup.find(key);
+	if(result != _stackNodeLookup.end()) {
+		return result->second;
+	}
+
+	if(_stackNodes.size() >= MaxStackNodes) {
+		//Too many unique call stacks, count the samples towards the caller instead
+		return parent;
+	}
+
+	uint32_t node = (uint32_t)_stackNodes.size();
+	_stackNodes.push_back({ parent, function });
+	_stackNodeLookup[key] = node;
+	return node;
+}
+
+void Profiler::UpdateSamples()
+{
+	uint64_t masterClock = _console->GetMasterClock();
+	if(masterClock < _nextSampleClock) {
+		return;
+	}
+
+	//All samples since the last call/return were taken with the current call stack
+	uint64_t count = (masterClock - _nextSampleClock) / _sampleInterval + 1;
+	_nextSampleClock += count * _sampleInterval;
+
+	ProfilerSample& prevSample = _samples[(_samplePos + _samples.size() - 1) % _samples.size()];
+	if((_samplePos > 0 || _samplesWrapped) && prevSample.StackId == _currentStackNode && prevSample.Count + count <= UINT32_MAX) {
+		prevSample.Count += (uint32_t)count;
+		return;
+	}
+
+	_samples[_samplePos] = { _currentStackNode, (uint32_t)std::min<uint64_t>(count, UINT32_MAX) };
+	_samplePos++;
+	if(_samplePos >= _samples.size()) {
+		//Buffer is full, overwrite the oldest samples
+		_samplePos = 0;
+		_samplesWrapped = true;
+	}
+}
+
+string Profiler::GetFunctionName(int32_t function)
+{
+	if(function == ResetFunctionIndex) {
+		return "[reset]";
+	}
+
+	AddressInfo addr = { function & 0xFFFFFF, (MemoryType)((uint32_t)function >> 24) };
+	string label = _debugger->GetLabelManager()->GetLabel(addr);
+	return label.empty() ? "$" + HexUtilities::ToHex24(addr.Address) : label;
+}
+
+bool Profiler::ExportFlameGraph(string filename)
+{
+	unordered_map<uint32_t, uint64_t> sampleCounts;
+	vector<ProfilerStackNode> stackNodes;
+	{
+		DebugBreakHelper helper(_debugger);
+		if(_samplingEnabled) {
+			UpdateSamples();
+		}
+
+		uint32_t sampleCount = _samplesWrapped ? (uint32_t)_samples.size() : _samplePos;
+		for(uint32_t i = 0; i < sampleCount; i++) {
+			sampleCounts[_samples[i].StackId] += _samples[i].Count;
+		}
+		stackNodes = _stackNodes;
+	}
+
+	ofstream file(filename, ios::out | ios::binary);
+	if(!file) {
+		return false;
+	}
+
+	unordered_map<int32_t, string> names;
+	vector<int32_t> stack;
+	for(auto& entry : sampleCounts) {
+		stack.clear();
+		for(uint32_t node = entry.first; node != 0; node = stackNodes[node].Parent) {
+			stack.push_back(stackNodes[node].Function);
+		}
+		stack.push_back(stackNodes[0].Function);
+
+		string line;
+		for(auto it = stack.rbegin(); it != stack.rend(); it++) {
+			auto name = names.find(*it);
+			if(name == names.end()) {
+				name = names.emplace(*it, GetFunctionName(*it)).first;
+			}
+			if(!line.empty()) {
+				line += ';';
+			}
+			line += name->second;
+		}
+		file << line << ' ' << entry.second << '\n';
+	}
+	return true;
+}
@@ -15,12 +15,44 @@ struct ProfiledFunction
 	AddressInfo Address = {};
 };
 
+//Used by the sampling mode: StackId is the call stack that was running when the samples were taken,
+//Count is the number of consecutive samples taken with that call stack
+struct ProfilerSample
+{
+	uint32_t StackId;
+	uint32_t Count;
+};
+
+//A call stack, stored as a tree: each node is a function called from its parent node's call stack
+struct ProfilerStackNode
+{
+	uint32_t Parent;
+	int32_t Function;
+};
+
 class Profiler
 {
 private:
+	static constexpr uint32_t MaxStackNodes = 0x100000;
+
 	Debugger* _debugger = nullptr;
 	IConsole* _console = nullptr;
 
+	//Sampling mode - instead of tracking the exact cycle count of each function on every call/return,
+	//the current call stack is sampled every _sampleInterval master clocks. Since the call stack can only
+	//change on a call/return, the samples taken since the last call/return are all recorded at once.
+	bool _samplingEnabled = false;
+	uint64_t _sampleInterval = 0;
+	uint64_t _nextSampleClock = 0;
+	vector<ProfilerSample> _samples;
+	uint32_t _samplePos = 0;
+	bool _samplesWrapped = false;
+
+	vector<ProfilerStackNode> _stackNodes;
+	unordered_map<uint64_t, uint32_t> _stackNodeLookup;
+	deque<uint32_t> _stackNodeStack;
+	uint32_t _currentStackNode = 0;
+
 	unordered_map<int32_t, ProfiledFunction> _functions;
 	
 	deque<int32_t> _functionStack;
@@ -33,6 +65,11 @@ private:
 
 	void InternalReset();
 	void UpdateCycles();
+	void ClearSamples();
+
+	uint32_t GetStackNode(uint32_t parent, int32_t function);
+	void UpdateSamples();
+	string GetFunctionName(int32_t function);
 
 public:
 	Profiler(Debugger* debugger, IConsole* _console);
@@ -44,4 +81,11 @@ public:
 	void Reset();
 	void ResetState();
 	void GetProfilerData(ProfiledFunction* profilerData, uint32_t& functionCount);
+
+	void StartSampling(uint32_t sampleInterval, uint32_t maxSamples);
+	void StopSampling();
+	bool IsSampling() { return _samplingEnabled; }
+
+	//Writes the samples in the collapsed stack format used by flame graph tools ("func1;func2;func3 count" per line)
+	bool ExportFlameGraph(string filename);
 };
\ No newline at end of file
@@ -1,35 +1,154 @@
 #include "pch.h"
 #include "PythonScriptingContext.h"
 #include "PythonApi.h"
+#include "PythonMemoryBuffer.h"
 #include "Utilities/FolderUtilities.h"
 #include "Debugger/Debugger.h"
 #include "Shared/Emulator.h"
 #include "Shared/SaveStateManager.h"
+#include "Shared/Audio/SoundMixer.h"
 #include "Shared/BaseControlManager.h"
 #include "Shared/BaseControlDevice.h"
+#include "Shared/PerfCounters.h"
+#include "Utilities/Serializer.h"
+#include "Utilities/magic_enum.hpp"
 
 static PyObject* PythonEmuLog(PyObject* self, PyObject* args);
+static bool GetMemoryBufferAddress(PyObject* args, void*& ptr);
+typedef shared_ptr<PythonScriptingContext::StateSnapshot> PythonStateSnapshot;
+static constexpr const char* StateCapsuleName = "mesen.state";
+
+static void PythonStateCapsuleDestructor(PyObject* capsule)
+{
+	delete (PythonStateSnapshot*)PyCapsule_GetPointer(capsule, StateCapsuleName);
+}
+
+static PyObject* CreateStateCapsule(PythonStateSnapshot snapshot)
+{
+	return PyCapsule_New(new PythonStateSnapshot(snapshot), StateCapsuleName, PythonStateCapsuleDestructor);
+}
+
+static PythonStateSnapshot* GetStateFromCapsule(PyObject* capsule)
+{
+	if(!PyCapsule_IsValid(capsule, StateCapsuleName)) {
+		PyErr_SetString(PyExc_TypeError, "Argument must be a handle returned by saveState or stateFromBytes");
+		return nullptr;
+	}
+	return (PythonStateSnapshot*)PyCapsule_GetPointer(capsule, StateCapsuleName);
+}
+
+static PyObject* PythonSaveState(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	return CreateStateCapsule(context->SaveSnapshot());
+}
+
+static PyObject* PythonLoadState(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	PyObject* pyCapsule;
+	if(!PyArg_ParseTuple(args, "O", &pyCapsule))
+		return nullptr;
+
+	PythonStateSnapshot* snapshot = GetStateFromCapsule(pyCapsule);
+	if(!snapshot)
+		return nullptr;
+
+	context->LoadSnapshot(*snapshot);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject* PythonStateToBytes(PyObject* self, PyObject* args)
+{
+	PyObject* pyCapsule;
+	if(!PyArg_ParseTuple(args, "O", &pyCapsule))
+		return nullptr;
+
+	PythonStateSnapshot* snapshot = GetStateFromCapsule(pyCapsule);
+	if(!snapshot)
+		return nullptr;
+
+	// The state is only available once the emulation has reached the next instruction
+	if(!(*snapshot)->State)
+		Py_RETURN_NONE;
+
+	vector<uint8_t>& data = (*snapshot)->State->GetData();
+	return PyBytes_FromStringAndSize((const char*)data.data(), data.size());
+}
+
+static PyObject* PythonStateFromBytes(PyObject* self, PyObject* args)
+{
+	const char* buffer = nullptr;
+	Py_ssize_t size = 0;
+	if(!PyArg_ParseTuple(args, "y#", &buffer, &size))
+		return nullptr;
+
+	PythonStateSnapshot snapshot(new PythonScriptingContext::StateSnapshot());
+	snapshot->State.reset(new Serializer(SaveStateManager::FileFormatVersion, false, SerializeFormat::Raw));
+	if(!snapshot->State->LoadFrom(vector<uint8_t>(buffer, buffer + size))) {
+		PyErr_SetString(PyExc_ValueError, "Invalid save state data");
+		return nullptr;
+	}
+
+	return CreateStateCapsule(snapshot);
+}
+
 static PyObject* PythonRead8(PyObject* self, PyObject* args);
+static PyObject* PythonReadRange(PyObject* self, PyObject* args);
 static PyObject* PythonRegisterFrameMemory(PyObject* self, PyObject* args);
 static PyObject* PythonUnregisterFrameMemory(PyObject* self, PyObject* args);
 static PyObject* PythonRegisterScreenMemory(PyObject* self, PyObject* args);
 static PyObject* PythonUnregisterScreenMemory(PyObject* self, PyObject* args);
+static PyObject* PythonSkipRendering(PyObject* self, PyObject* args);
+static PyObject* PythonSetAudioSink(PyObject* self, PyObject* args);
+static PyObject* PythonReadAudioSamples(PyObject* self, PyObject* args);
+static PyObject* PythonGetPerfStats(PyObject* self, PyObject* args);
+static PyObject* PythonResetPerfStats(PyObject* self, PyObject* args);
+static PyObject* PythonAddMemoryCallback(PyObject* self, PyObject* args);
+static PyObject* PythonRemoveMemoryCallback(PyObject* self, PyObject* args);
 static PyObject* PythonAddEventCallback(PyObject* self, PyObject* args);
 static PyObject* PythonRemoveEventCallback(PyObject* self, PyObject* args);
 static PyObject* PythonLoadSaveState(PyObject* self, PyObject* args);
+static PyObject* PythonSaveState(PyObject* self, PyObject* args);
+static PyObject* PythonLoadState(PyObject* self, PyObject* args);
+static PyObject* PythonStateToBytes(PyObject* self, PyObject* args);
+static PyObject* PythonStateFromBytes(PyObject* self, PyObject* args);
 static PyObject* PythonSetInput(PyObject* self, PyObject* args);
 static PyObject* PythonGetInput(PyObject* self, PyObject* args);
 
 static PyMethodDef MyMethods[] = {
 	{"log", PythonEmuLog, METH_VARARGS, "Logging function"},
 	{"read8", PythonRead8, METH_VARARGS, "Read 8-bit value from memory"},
+	{"readRange", PythonReadRange, METH_VARARGS, "Read a range of 8-bit values from memory, returned as bytes"},
 	{"registerFrameMemory", PythonRegisterFrameMemory, METH_VARARGS, "Register memory addresses (and sizes) to be tracked and updated every frame."},
 	{"unregisterFrameMemory", PythonUnregisterFrameMemory, METH_VARARGS, "Unregister frame memory updates."},
-	{"registerScreenMemory", PythonRegisterScreenMemory, METH_VARARGS, "Register screen memory addresses (and sizes) to be tracked and updated every frame."},
+	{"registerScreenMemory", PythonRegisterScreenMemory, METH_VARARGS, "Register screen memory to be updated every frame.  e.g. emu.registerScreenMemory(screenFormat.grayscale, 2)"},
 	{"unregisterScreenMemory", PythonUnregisterScreenMemory, METH_VARARGS, "Unregister screen memory updates."},
+	{"skipRendering", PythonSkipRendering, METH_VARARGS, "Skips drawing the next frames' pixels (until called with False), the emulation itself is unaffected."},
+	{"setAudioSink", PythonSetAudioSink, METH_VARARGS, "Sets what is done with the console's audio samples.  e.g. emu.setAudioSink(audioSink.capture)"},
+	{"readAudioSamples", PythonReadAudioSamples, METH_VARARGS, "Returns the audio samples captured since the last call (16-bit stereo, as bytes) and their sample rate."},
+	{"getPerfStats", PythonGetPerfStats, METH_VARARGS, "Returns the host time spent in the emulator's main steps (count, total/min/max time in ns and a histogram for each step)."},
+	{"resetPerfStats", PythonResetPerfStats, METH_VARARGS, "Resets the values returned by getPerfStats."},
+	{"addMemoryCallback", PythonAddMemoryCallback, METH_VARARGS, "Adds a memory callback.  e.g. emu.addMemoryCallback(function, callbackType.write, startAddress, endAddress, cpuType, memoryType)"},
+	{"removeMemoryCallback", PythonRemoveMemoryCallback, METH_VARARGS, "Removes a memory callback (the arguments must match the ones given to addMemoryCallback)."},
 	{"addEventCallback", PythonAddEventCallback, METH_VARARGS, "Adds an event callback.  e.g. emu.addEventCallback(function, eventType.startFrame)"},
 	{"removeEventCallback", PythonRemoveEventCallback, METH_VARARGS, "Removes an event callback."},
 	{"loadSaveState", PythonLoadSaveState, METH_VARARGS, "Loads a save state."},
+	{"saveState", PythonSaveState, METH_VARARGS, "Creates an in-memory save state (taken at the start of the next instruction) and returns its handle."},
+	{"loadState", PythonLoadState, METH_VARARGS, "Loads an in-memory save state (at the start of the next instruction)."},
+	{"stateToBytes", PythonStateToBytes, METH_VARARGS, "Returns the content of an in-memory save state as bytes."},
+	{"stateFromBytes", PythonStateFromBytes, METH_VARARGS, "Creates an in-memory save state handle from bytes returned by stateToBytes."},
 	{"setInput", PythonSetInput, METH_VARARGS, "Sets input for a controller."},
 	{"getInput", PythonGetInput, METH_VARARGS, "Gets input for a controller."},
 	{NULL, NULL, 0, NULL}
@@ -141,6 +260,50 @@ static PyObject* PythonRead8(PyObject* self, PyObject* args)
 
 
 
+static bool GetMemoryBufferAddress(PyObject* args, void*& ptr)
+{
+	// Accepts the buffer returned by registerFrameMemory/registerScreenMemory, or its address as an integer
+	PyObject* pyHandle;
+	if(!PyArg_ParseTuple(args, "O", &pyHandle))
+		return false;
+
+	PythonMemoryBuffer* buffer = GetPythonMemoryBuffer(pyHandle);
+	if(buffer) {
+		ptr = buffer->Data;
+		return true;
+	}
+
+	ptr = PyLong_AsVoidPtr(pyHandle);
+	return !PyErr_Occurred();
+}
+static PyObject* PythonReadRange(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	// Expected: memory type, start address, length
+	int kind;
+	unsigned int start, length;
+	if(!PyArg_ParseTuple(args, "iII", &kind, &start, &length))
+		return nullptr;
+
+	if(kind < 0 || kind >= (int)MemoryType::None) {
+		PyErr_SetString(PyExc_TypeError, "First argument must be a valid memoryType");
+		return nullptr;
+	}
+
+	// Read directly into the bytes object's storage
+	PyObject* result = PyBytes_FromStringAndSize(nullptr, length);
+	if(!result)
+		return nullptr;
+
+	context->ReadMemoryRange(static_cast<MemoryType>(kind), start, length, (uint8_t*)PyBytes_AS_STRING(result));
+	return result;
+}
+
 static PyObject* PythonUnregisterScreenMemory(PyObject* self, PyObject* args)
 {
 	PythonScriptingContext* context = GetScriptingContextFromThreadState();
@@ -150,7 +313,7 @@ static PyObject* PythonUnregisterScreenMemory(PyObject* self, PyObject* args)
 	}
 
 	void* ptr;
-	if(!PyArg_ParseTuple(args, "p", &ptr))
+	if(!GetMemoryBufferAddress(args, ptr))
 		return nullptr;
 
 	bool result = context->UnregisterScreenMemory(ptr);
@@ -168,11 +331,131 @@ static PyObject* PythonRegisterScreenMemory(PyObject* self, PyObject* args)
 		return nullptr;
 	}
 
-	void* ptr = context->RegisterScreenMemory();
-	if(ptr == nullptr)
+	// Optional args: (screen format, downscale factor for the grayscale format)
+	int format = (int)PythonScreenFormat::Rgb;
+	unsigned int scale = 1;
+	if(!PyArg_ParseTuple(args, "|iI", &format, &scale))
+		return nullptr;
+
+	if(format < (int)PythonScreenFormat::Rgb || format > (int)PythonScreenFormat::Grayscale) {
+		PyErr_SetString(PyExc_TypeError, "First argument must be a valid screenFormat");
+		return nullptr;
+	}
+
+	PyObject* buffer = context->RegisterScreenMemory(static_cast<PythonScreenFormat>(format), scale);
+	if(buffer == nullptr)
 		Py_RETURN_NONE;
 
-	return PyLong_FromVoidPtr(ptr);
+	return buffer;
+}
+
+static PyObject* PythonSkipRendering(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	int skip;
+	if(!PyArg_ParseTuple(args, "p", &skip))
+		return nullptr;
+
+	context->GetDebugger()->GetEmulator()->SetSkipRendering(skip != 0);
+	Py_RETURN_NONE;
+}
+
+static PyObject* PythonSetAudioSink(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	int mode;
+	if(!PyArg_ParseTuple(args, "i", &mode))
+		return nullptr;
+
+	if(mode < (int)AudioSinkMode::Default || mode > (int)AudioSinkMode::Capture) {
+		PyErr_SetString(PyExc_ValueError, "Argument must be a valid audioSink value");
+		return nullptr;
+	}
+
+	context->GetDebugger()->GetEmulator()->GetSoundMixer()->SetSinkMode((AudioSinkMode)mode);
+	Py_RETURN_NONE;
+}
+
+static PyObject* PythonReadAudioSamples(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	vector<int16_t> samples;
+	uint32_t sampleRate = context->GetDebugger()->GetEmulator()->GetSoundMixer()->ReadCapturedSamples(samples);
+	PyObject* data = PyBytes_FromStringAndSize((const char*)samples.data(), samples.size() * sizeof(int16_t));
+	if(!data)
+		return nullptr;
+
+	return Py_BuildValue("(NI)", data, sampleRate);
+}
+
+static PyObject* PythonGetPerfStats(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	PerfCounterStats stats[PerfCounters::CounterTypeCount];
+	context->GetDebugger()->GetEmulator()->GetPerfCounters()->GetStats(stats);
+
+	PyObject* result = PyDict_New();
+	if(!result)
+		return nullptr;
+
+	for(int i = 0; i < PerfCounters::CounterTypeCount; i++) {
+		PyObject* histogram = PyList_New(PerfCounterStats::HistogramSize);
+		if(!histogram) {
+			Py_DECREF(result);
+			return nullptr;
+		}
+		for(int j = 0; j < PerfCounterStats::HistogramSize; j++) {
+			PyList_SET_ITEM(histogram, j, PyLong_FromUnsignedLongLong(stats[i].Histogram[j]));
+		}
+
+		PyObject* counter = Py_BuildValue("{s:K,s:K,s:K,s:K,s:N}",
+			"count", stats[i].Count,
+			"totalNs", stats[i].TotalNs,
+			"minNs", stats[i].MinNs,
+			"maxNs", stats[i].MaxNs,
+			"histogram", histogram
+		);
+		if(!counter || PyDict_SetItemString(result, PerfCounters::GetCounterName((PerfCounterType)i), counter) != 0) {
+			Py_XDECREF(counter);
+			Py_DECREF(result);
+			return nullptr;
+		}
+		Py_DECREF(counter);
+	}
+
+	return result;
+}
+
+static PyObject* PythonResetPerfStats(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	context->GetDebugger()->GetEmulator()->GetPerfCounters()->Reset();
+	Py_RETURN_NONE;
 }
 
 static PyObject* PythonRegisterFrameMemory(PyObject* self, PyObject* args)
@@ -213,11 +496,11 @@ static PyObject* PythonRegisterFrameMemory(PyObject* self, PyObject* args)
 
 	Py_DECREF(pyIter);
 
-	void* ptr = context->RegisterFrameMemory(static_cast<MemoryType>(memType), result);
-	if(ptr == nullptr)
+	PyObject* buffer = context->RegisterFrameMemory(static_cast<MemoryType>(memType), result);
+	if(buffer == nullptr)
 		Py_RETURN_NONE;
 
-	return PyLong_FromVoidPtr(ptr);
+	return buffer;
 }
 
 static PyObject* PythonGetInput(PyObject* self, PyObject* args)
@@ -317,7 +600,7 @@ static PyObject* PythonUnregisterFrameMemory(PyObject* self, PyObject* args)
 	}
 
 	void* ptr;
-	if(!PyArg_ParseTuple(args, "p", &ptr))
+	if(!GetMemoryBufferAddress(args, ptr))
 		return nullptr;
 
 	bool result = context->UnregisterFrameMemory(ptr);
@@ -327,6 +610,88 @@ static PyObject* PythonUnregisterFrameMemory(PyObject* self, PyObject* args)
 	Py_RETURN_FALSE;
 }
 
+static bool ParseMemoryCallbackArgs(PythonScriptingContext* context, PyObject* args, PyObject*& pyFunc, CallbackType& type, int& startAddr, int& endAddr, CpuType& cpuType, MemoryType& memType)
+{
+	// Extract args as (function, CallbackType enum, start address, [end address], [CpuType enum], [MemoryType enum])
+	int callbackType = 0;
+	int cpu = -1;
+	int mem = -1;
+	endAddr = -1;
+	if(!PyArg_ParseTuple(args, "Oii|iii", &pyFunc, &callbackType, &startAddr, &endAddr, &cpu, &mem))
+		return false;
+
+	if(!PyCallable_Check(pyFunc)) {
+		PyErr_SetString(PyExc_TypeError, "First argument must be callable");
+		return false;
+	}
+
+	if(callbackType < (int)CallbackType::Read || callbackType > (int)CallbackType::Exec) {
+		PyErr_SetString(PyExc_TypeError, "Second argument must be a valid callbackType");
+		return false;
+	}
+
+	if(endAddr == -1)
+		endAddr = startAddr;
+
+	if(startAddr < 0 || startAddr > endAddr) {
+		PyErr_SetString(PyExc_ValueError, "Start address must be >= 0 and <= end address");
+		return false;
+	}
+
+	type = static_cast<CallbackType>(callbackType);
+	cpuType = cpu == -1 ? context->GetDefaultCpuType() : static_cast<CpuType>(cpu);
+	memType = mem == -1 ? context->GetDefaultMemType() : static_cast<MemoryType>(mem);
+	if(!magic_enum::enum_contains<CpuType>(cpuType) || mem < -1 || memType >= MemoryType::None) {
+		PyErr_SetString(PyExc_TypeError, "Invalid cpu or memory type");
+		return false;
+	}
+
+	return true;
+}
+
+static PyObject* PythonAddMemoryCallback(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	PyObject* pyFunc;
+	CallbackType type;
+	int startAddr, endAddr;
+	CpuType cpuType;
+	MemoryType memType;
+	if(!ParseMemoryCallbackArgs(context, args, pyFunc, type, startAddr, endAddr, cpuType, memType))
+		return nullptr;
+
+	context->RegisterMemoryCallback(type, startAddr, endAddr, memType, cpuType, pyFunc);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject* PythonRemoveMemoryCallback(PyObject* self, PyObject* args)
+{
+	PythonScriptingContext* context = GetScriptingContextFromThreadState();
+	if(!context) {
+		PyErr_SetString(PyExc_TypeError, "No registered python context.");
+		return nullptr;
+	}
+
+	PyObject* pyFunc;
+	CallbackType type;
+	int startAddr, endAddr;
+	CpuType cpuType;
+	MemoryType memType;
+	if(!ParseMemoryCallbackArgs(context, args, pyFunc, type, startAddr, endAddr, cpuType, memType))
+		return nullptr;
+
+	if(context->UnregisterMemoryCallback(type, startAddr, endAddr, memType, cpuType, pyFunc))
+		Py_RETURN_TRUE;
+
+	Py_RETURN_FALSE;
+}
+
 static PyObject* PythonAddEventCallback(PyObject* self, PyObject* args)
 {
 	PythonScriptingContext* context = GetScriptingContextFromThreadState();
@@ -418,45 +783,137 @@ static string ReadFileContents(const string& path)
 	return buffer.str();
 }
 
-std::unordered_map<PyThreadState*, PythonScriptingContext*> s_pythonContexts;
-
+//Each script runs in its own sub-interpreter, the context is found from the interpreter running the api call
+static SimpleLock s_contextLock;
+static std::unordered_map<PyInterpreterState*, PythonScriptingContext*> s_pythonContexts;
+static SimpleLock s_initLock;
 
+//Gives the current thread a thread state on the main interpreter, used to hold the GIL while
+//sub-interpreters are created/destroyed. It is kept (and registered as the thread's GIL state)
+//for the thread's lifetime, so thread states created for the sub-interpreters never are.
+static void InitMainThreadState()
+{
+	static thread_local bool initDone = false;
+	if(!initDone) {
+		initDone = true;
+		PyGILState_Ensure();
+		PyEval_SaveThread();
+	}
+}
 
 PyThreadState *InitializePython(PythonScriptingContext *context, const string & path)
 {
+	PyThreadState* previous = PythonInterpreterHolder::Suspend();
+	auto lock = s_initLock.AcquireSafe();
+
 	if(!Py_IsInitialized())
 	{
 		PyImport_AppendInittab("mesen_", PyInit_mesen);
 		Py_Initialize();
+
+		//The GIL is only held while python code runs, release it
+		PyEval_SaveThread();
 	}
 
-#ifdef USE_SUBINTERPRETERS
+	InitMainThreadState();
+	PyGILState_STATE gil = PyGILState_Ensure();
+	PyThreadState* mainState = PyThreadState_Get();
+
 	PyThreadState* curr = Py_NewInterpreter();
-	PyThreadState* old = PyThreadState_Swap(curr);
-#else
-	PyThreadState* curr = nullptr;
-#endif
-	s_pythonContexts[curr] = context;
-
-	// add script directory to sys.path
-	PyObject* sysPath = PySys_GetObject("path"); // Borrowed reference
-	if(sysPath) {
-		PyObject* pPath = PyUnicode_FromString(path.c_str());
-		if(pPath) {
-			PyList_Insert(sysPath, 0, pPath);
-			Py_DECREF(pPath);
+	if(curr) {
+		{
+			auto contextLock = s_contextLock.AcquireSafe();
+			s_pythonContexts[PyThreadState_GetInterpreter(curr)] = context;
+		}
+
+		// add script directory to sys.path
+		PyObject* sysPath = PySys_GetObject("path"); // Borrowed reference
+		if(sysPath) {
+			PyObject* pPath = PyUnicode_FromString(path.c_str());
+			if(pPath) {
+				PyList_Insert(sysPath, 0, pPath);
+				Py_DECREF(pPath);
+			}
 		}
 	}
 
-#ifdef USE_SUBINTERPRETERS
-	PyThreadState_Swap(old);
-#endif
+	PyThreadState_Swap(mainState);
+	PyGILState_Release(gil);
 
+	lock.Release();
+	PythonInterpreterHolder::Resume(previous);
 	return curr;
 }
 
+void PythonInterpreterHandler::Attach(PyThreadState* state)
+{
+	auto lock = _stateLock.AcquireSafe();
+	_threadStates.clear();
+	if(state) {
+		_threadStates.push_back({ std::this_thread::get_id(), state });
+	}
+	_interpreter = state ? PyThreadState_GetInterpreter(state) : nullptr;
+}
+
+PyThreadState* PythonInterpreterHandler::GetThreadState()
+{
+	if(!_interpreter) {
+		return nullptr;
+	}
+
+	std::thread::id threadId = std::this_thread::get_id();
+	auto lock = _stateLock.AcquireSafe();
+	for(std::pair<std::thread::id, PyThreadState*>& threadState : _threadStates) {
+		if(threadState.first == threadId) {
+			return threadState.second;
+		}
+	}
+
+	//First time this thread runs the script's code
+	InitMainThreadState();
+	PyThreadState* state = PyThreadState_New(_interpreter);
+	_threadStates.push_back({ threadId, state });
+	return state;
+}
+
+void PythonInterpreterHandler::Detach()
+{
+	if(!_interpreter) {
+		return;
+	}
+
+	PyThreadState* previous = PythonInterpreterHolder::Suspend();
+	if(previous && PyThreadState_GetInterpreter(previous) == _interpreter) {
+		//The thread state is deleted below
+		previous = nullptr;
+	}
+
+	InitMainThreadState();
+	PyGILState_STATE gil = PyGILState_Ensure();
+	PyThreadState* mainState = PyThreadState_Get();
+
+	//Py_EndInterpreter requires all of the interpreter's other thread states to be deleted first
+	PyThreadState* state = PyThreadState_New(_interpreter);
+	PyThreadState_Swap(state);
+	{
+		auto lock = _stateLock.AcquireSafe();
+		for(std::pair<std::thread::id, PyThreadState*>& threadState : _threadStates) {
+			PyThreadState_Clear(threadState.second);
+			PyThreadState_Delete(threadState.second);
+		}
+		_threadStates.clear();
+		_interpreter = nullptr;
+	}
+	Py_EndInterpreter(state);
+
+	PyThreadState_Swap(mainState);
+	PyGILState_Release(gil);
+	PythonInterpreterHolder::Resume(previous);
+}
+
 void ReportEndScriptingContext(PythonScriptingContext* ctx)
 {
+	auto lock = s_contextLock.AcquireSafe();
 	for(auto it = s_pythonContexts.begin(); it != s_pythonContexts.end(); ++it)
 	{
 		if(it->second == ctx)
@@ -469,15 +926,12 @@ void ReportEndScriptingContext(PythonScriptingContext* ctx)
 
 PythonScriptingContext* GetScriptingContextFromThreadState()
 {
-#if USE_SUBINTERPRETERS
-	PyThreadState* state = PyThreadState_Get();
-#else
-	PyThreadState* state = nullptr;
-#endif
+	PyInterpreterState* interpreter = PyInterpreterState_Get();
 
-	auto it = s_pythonContexts.find(state);
+	auto lock = s_contextLock.AcquireSafe();
+	auto it = s_pythonContexts.find(interpreter);
 	if(it != s_pythonContexts.end())
 		return it->second;
 
 	return nullptr;
-}
\ No newline at end of file
+}
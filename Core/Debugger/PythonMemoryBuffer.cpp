@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "PythonMemoryBuffer.h"
+
+static void PythonMemoryBufferDealloc(PyObject* self)
+{
+	delete[] ((PythonMemoryBuffer*)self)->Data;
+	Py_TYPE(self)->tp_free(self);
+}
+
+static int PythonMemoryBufferGetBuffer(PyObject* self, Py_buffer* view, int flags)
+{
+	PythonMemoryBuffer* buffer = (PythonMemoryBuffer*)self;
+
+	//Without a shape, consumers treat the buffer as a 1D array of unsigned bytes
+	//Without a format, the items are assumed to be unsigned bytes ("B")
+	if(buffer->ItemSize > 1 && !(flags & PyBUF_ND)) {
+		view->obj = nullptr;
+		PyErr_SetString(PyExc_BufferError, "MemoryBuffer: the buffer's items are not bytes, the shape must be requested (PyBUF_ND).");
+		return -1;
+	} else if(buffer->ItemSize > 1 && !(flags & PyBUF_FORMAT)) {
+		view->obj = nullptr;
+		PyErr_SetString(PyExc_BufferError, "MemoryBuffer: the buffer's items are not bytes, the format must be requested (PyBUF_FORMAT).");
+		return -1;
+	}
+
+	view->obj = self;
+	view->buf = buffer->Data;
+	view->len = buffer->Size;
+	view->readonly = 0;
+	view->itemsize = buffer->ItemSize;
+	view->format = (flags & PyBUF_FORMAT) ? (char*)buffer->Format : nullptr;
+	view->ndim = (flags & PyBUF_ND) ? buffer->Dimensions : 1;
+	view->shape = (flags & PyBUF_ND) ? buffer->Shape : nullptr;
+	view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? buffer->Strides : nullptr;
+	view->suboffsets = nullptr;
+	view->internal = nullptr;
+
+	Py_INCREF(self);
+	return 0;
+}
+
+static Py_ssize_t PythonMemoryBufferLength(PyObject* self)
+{
+	PythonMemoryBuffer* buffer = (PythonMemoryBuffer*)self;
+	return buffer->Shape[0];
+}
+
+static PyBufferProcs PythonMemoryBufferProcs = {
+	PythonMemoryBufferGetBuffer,
+	nullptr
+};
+
+static PySequenceMethods PythonMemoryBufferSequence = {
+	PythonMemoryBufferLength
+};
+
+static PyTypeObject PythonMemoryBufferType = {
+	PyVarObject_HEAD_INIT(nullptr, 0)
+	"emu.MemoryBuffer"
+};
+
+static bool InitPythonMemoryBufferType()
+{
+	PythonMemoryBufferType.tp_basicsize = sizeof(PythonMemoryBuffer);
+	PythonMemoryBufferType.tp_flags = Py_TPFLAGS_DEFAULT;
+	PythonMemoryBufferType.tp_doc = "Memory updated by the emulator (supports the buffer protocol, e.g numpy.asarray(buffer))";
+	PythonMemoryBufferType.tp_dealloc = PythonMemoryBufferDealloc;
+	PythonMemoryBufferType.tp_as_buffer = &PythonMemoryBufferProcs;
+	PythonMemoryBufferType.tp_as_sequence = &PythonMemoryBufferSequence;
+	return PyType_Ready(&PythonMemoryBufferType) == 0;
+}
+
+PythonMemoryBuffer* CreatePythonMemoryBuffer(std::initializer_list<Py_ssize_t> shape, Py_ssize_t itemSize, const char* format)
+{
+	static bool typeReady = InitPythonMemoryBufferType();
+	if(!typeReady || shape.size() == 0 || shape.size() > 3) {
+		return nullptr;
+	}
+
+	PythonMemoryBuffer* buffer = PyObject_New(PythonMemoryBuffer, &PythonMemoryBufferType);
+	if(!buffer) {
+		return nullptr;
+	}
+
+	buffer->ItemSize = itemSize;
+	buffer->Format = format;
+	buffer->Dimensions = (int)shape.size();
+
+	Py_ssize_t size = itemSize;
+	int i = 0;
+	for(Py_ssize_t dimension : shape) {
+		buffer->Shape[i++] = dimension;
+		size *= dimension;
+	}
+
+	//C-contiguous layout: the last dimension's elements are next to each other
+	Py_ssize_t stride = itemSize;
+	for(i = buffer->Dimensions - 1; i >= 0; i--) {
+		buffer->Strides[i] = stride;
+		stride *= buffer->Shape[i];
+	}
+
+	buffer->Size = size;
+	buffer->Data = new uint8_t[size];
+	memset(buffer->Data, 0, size);
+	return buffer;
+}
+
+PythonMemoryBuffer* GetPythonMemoryBuffer(PyObject* obj)
+{
+	return obj && Py_TYPE(obj) == &PythonMemoryBufferType ? (PythonMemoryBuffer*)obj : nullptr;
+}
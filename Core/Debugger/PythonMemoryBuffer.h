@@ -0,0 +1,25 @@
+#pragma once
+#include "pch.h"
+#include "PythonApi.h"
+
+//Python object exposing a block of memory filled by the emulator through the buffer protocol, so it
+//can be used with memoryview/numpy (e.g numpy.asarray(buffer)) without copying the data.
+//The memory is owned by the object, which stays valid for as long as any Python object references it.
+struct PythonMemoryBuffer
+{
+	PyObject_HEAD
+	uint8_t* Data;
+	Py_ssize_t Size;
+	Py_ssize_t ItemSize;
+	const char* Format;
+	int Dimensions;
+	Py_ssize_t Shape[3];
+	Py_ssize_t Strides[3];
+};
+
+//Creates a new buffer (C-contiguous, zero-filled) with the given shape (up to 3 dimensions).
+//format is a struct module format string matching itemSize (e.g "B" for uint8, "H" for uint16)
+PythonMemoryBuffer* CreatePythonMemoryBuffer(std::initializer_list<Py_ssize_t> shape, Py_ssize_t itemSize, const char* format);
+
+//Returns the buffer if the object is a PythonMemoryBuffer, nullptr otherwise
+PythonMemoryBuffer* GetPythonMemoryBuffer(PyObject* obj);
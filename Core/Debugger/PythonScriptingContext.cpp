@@ -11,64 +11,174 @@
 #include "Utilities/magic_enum.hpp"
 #include "Shared/EventType.h"
 #include "Debugger/MemoryDumper.h"
+#include "Debugger/DebugUtilities.h"
 #include "PythonApi.h"
+#include "PythonMemoryBuffer.h"
 #include "Shared/Video/BaseVideoFilter.h"
+#include "Utilities/Serializer.h"
 
-void *PythonScriptingContext::RegisterScreenMemory()
+PyObject* PythonScriptingContext::RegisterScreenMemory(PythonScreenFormat format, uint32_t scale)
 {
-	_frameBufferRegisterCount++;
-	return _frameBuffer;
+	scale = format == PythonScreenFormat::Grayscale ? std::max<uint32_t>(scale, 1) : 1;
+
+	auto result = std::find_if(_screenMemory.begin(), _screenMemory.end(), [=](const ScreenRegistry& entry) { return entry.Format == format && entry.Scale == scale; });
+	if(result == _screenMemory.end()) {
+		_screenMemory.push_back({ format, scale, nullptr, 0, {} });
+		result = _screenMemory.end() - 1;
+	}
+	result->RegisterCount++;
+
+	// Fill the buffers right away, this allocates them based on the current frame's size
+	UpdateScreenMemory();
+
+	ScreenRegistry& reg = *result;
+	if(!reg.Buffer)
+		return nullptr;
+
+	Py_INCREF(reg.Buffer);
+	return (PyObject*)reg.Buffer;
 }
 
 
 bool PythonScriptingContext::UnregisterScreenMemory(void* ptr)
 {
-	if(ptr == _frameBuffer && _frameBufferRegisterCount > 0) {
-		_frameBufferRegisterCount--;
-		return true;
+	for(auto it = _screenMemory.begin(); it != _screenMemory.end(); it++) {
+		bool found = false;
+		if(it->Buffer && ptr == it->Buffer->Data) {
+			it->RegisterCount--;
+			found = true;
+		} else {
+			for(auto old = it->OldBuffers.begin(); old != it->OldBuffers.end(); old++) {
+				if(ptr == old->Buffer->Data) {
+					if(--old->RegisterCount <= 0) {
+						Py_DECREF(old->Buffer);
+						it->OldBuffers.erase(old);
+					}
+					found = true;
+					break;
+				}
+			}
+		}
+
+		if(found) {
+			if(it->RegisterCount <= 0 && it->OldBuffers.empty()) {
+				Py_XDECREF(it->Buffer);
+				_screenMemory.erase(it);
+			}
+			return true;
+		}
 	}
 
 	return false;
 }
 
-void* PythonScriptingContext::RegisterFrameMemory(MemoryType type, const std::vector<int>& addresses)
+PyObject* PythonScriptingContext::RegisterFrameMemory(MemoryType type, const std::vector<int>& addresses)
 {
 	if(addresses.empty())
 		return nullptr;
 
-	uint8_t* result = new uint8_t[addresses.size()];
-	memset(result, 0, addresses.size() * sizeof(uint8_t));
+	PythonMemoryBuffer* buffer = CreatePythonMemoryBuffer({ (Py_ssize_t)addresses.size() }, 1, "B");
+	if(!buffer)
+		return nullptr;
 
 	MemoryRegistry reg = {};
 	reg.Type = type;
-	reg.BaseAddress = result;
+	reg.Buffer = buffer;
+	reg.BaseAddress = buffer->Data;
 	reg.Addresses = addresses;
 
-	_frameMemory.push_back(reg);
+	BuildFrameMemoryPlan(reg);
 	FillOneFrameMemory(reg);
+	_frameMemory.push_back(std::move(reg));
 
-	return result;
+	// The registry keeps its own reference, the caller receives a new one
+	Py_INCREF(buffer);
+	return (PyObject*)buffer;
 }
 
 bool PythonScriptingContext::UnregisterFrameMemory(void* ptr)
 {
-	size_t count = _frameMemory.size();
-
-	_frameMemory.erase(std::remove_if(_frameMemory.begin(), _frameMemory.end(), [ptr](const MemoryRegistry& entry) { return ptr == entry.BaseAddress; }), _frameMemory.end());
-
-	if(count == _frameMemory.size())
+	auto result = std::find_if(_frameMemory.begin(), _frameMemory.end(), [ptr](const MemoryRegistry& entry) { return ptr == entry.BaseAddress; });
+	if(result == _frameMemory.end())
 		return false;
 
-	delete[] ptr;
+	// The memory itself is freed once Python no longer references the buffer
+	Py_DECREF(result->Buffer);
+	_frameMemory.erase(result);
 	return true;
 }
 
+void PythonScriptingContext::ReleaseMemoryBuffers()
+{
+	for(MemoryRegistry& reg : _frameMemory)
+		Py_DECREF(reg.Buffer);
+	_frameMemory.clear();
+
+	for(ScreenRegistry& reg : _screenMemory) {
+		Py_XDECREF(reg.Buffer);
+		for(ScreenBufferRef& old : reg.OldBuffers)
+			Py_DECREF(old.Buffer);
+	}
+	_screenMemory.clear();
+}
+
+uint8_t* PythonScriptingContext::GetFixedMemoryPointer(MemoryType type, uint32_t address)
+{
+	if(DebugUtilities::IsRelativeMemory(type)) {
+		//Only CPU addresses that always map to the same internal RAM can be resolved ahead of time,
+		//everything else may be remapped by the mappers/bank registers at any time
+		AddressInfo absAddr = _debugger->GetAbsoluteAddress({ (int32_t)address, type });
+		switch(absAddr.Type) {
+			case MemoryType::NesInternalRam:
+			case MemoryType::SnesWorkRam:
+			case MemoryType::GbHighRam:
+			case MemoryType::SmsWorkRam:
+				type = absAddr.Type;
+				address = (uint32_t)absAddr.Address;
+				break;
+
+			default:
+				return nullptr;
+		}
+	}
+
+	ConsoleMemoryInfo memory = _debugger->GetEmulator()->GetMemory(type);
+	return memory.Memory && address < memory.Size ? (uint8_t*)memory.Memory + address : nullptr;
+}
+
+void PythonScriptingContext::BuildFrameMemoryPlan(MemoryRegistry& reg)
+{
+	reg.Copies.clear();
+	reg.Reads.clear();
+
+	for(uint32_t i = 0; i < (uint32_t)reg.Addresses.size(); i++) {
+		uint8_t* src = reg.Addresses[i] >= 0 ? GetFixedMemoryPointer(reg.Type, (uint32_t)reg.Addresses[i]) : nullptr;
+		if(!src) {
+			reg.Reads.push_back({ i, (uint32_t)reg.Addresses[i] });
+			continue;
+		}
+
+		//Merge with the previous run when both the source and destination are contiguous
+		if(!reg.Copies.empty()) {
+			FrameMemoryCopy& last = reg.Copies.back();
+			if(last.Offset + last.Length == i && last.Source + last.Length == src) {
+				last.Length++;
+				continue;
+			}
+		}
+		reg.Copies.push_back({ src, i, 1 });
+	}
+}
+
 void PythonScriptingContext::FillOneFrameMemory(const MemoryRegistry& reg)
 {
-	auto ptr = reg.BaseAddress;
-	for(auto addr : reg.Addresses) {
-		uint8_t value = _memoryDumper->GetMemoryValue(reg.Type, addr, true);
-		*ptr++ = value;
+	uint8_t* dst = reg.BaseAddress;
+	for(const FrameMemoryCopy& copy : reg.Copies) {
+		memcpy(dst + copy.Offset, copy.Source, copy.Length);
+	}
+
+	for(const FrameMemoryRead& read : reg.Reads) {
+		dst[read.Offset] = _memoryDumper->GetMemoryValue(reg.Type, read.Address, true);
 	}
 }
 
@@ -78,20 +188,96 @@ void PythonScriptingContext::UpdateFrameMemory()
 		FillOneFrameMemory(reg);
 }
 
+bool PythonScriptingContext::UpdateScreenBufferSize(ScreenRegistry& reg, uint32_t width, uint32_t height)
+{
+	width /= reg.Scale;
+	height /= reg.Scale;
+
+	PythonMemoryBuffer* buffer = reg.Buffer;
+	if(buffer && buffer->Shape[0] == (Py_ssize_t)height && buffer->Shape[1] == (Py_ssize_t)width)
+		return true;
+
+	if(reg.Buffer && reg.RegisterCount > 0) {
+		// The resolution changed (e.g SNES high res/interlace): the buffer's shape can't change, so a new buffer is
+		// created. The old one stays valid (but is no longer updated) and can still be unregistered by the script.
+		reg.OldBuffers.push_back({ reg.Buffer, reg.RegisterCount });
+		reg.RegisterCount = 0;
+		Log("Screen resolution changed to " + std::to_string(width) + "x" + std::to_string(height) + ", the buffers returned by registerScreenMemory are no longer updated. Call registerScreenMemory again to get the new buffer.");
+	} else {
+		Py_XDECREF(reg.Buffer);
+	}
+
+	switch(reg.Format) {
+		default:
+		case PythonScreenFormat::Rgb: reg.Buffer = CreatePythonMemoryBuffer({ height, width, 4 }, 1, "B"); break;
+		case PythonScreenFormat::Raw: reg.Buffer = CreatePythonMemoryBuffer({ height, width }, sizeof(uint16_t), "H"); break;
+		case PythonScreenFormat::Grayscale: reg.Buffer = CreatePythonMemoryBuffer({ height, width }, 1, "B"); break;
+	}
+	return reg.Buffer != nullptr;
+}
+
 void PythonScriptingContext::UpdateScreenMemory()
 {
-	if(_frameBufferRegisterCount > 0) {
-		Emulator* _emu = _debugger->GetEmulator();
-		PpuFrameInfo frame = _emu->GetPpuFrame();
-		FrameInfo frameSize = { 0 };
-		frameSize.Height = frame.Height;
-		frameSize.Width = frame.Width;
+	if(_screenMemory.empty())
+		return;
+
+	Emulator* emu = _debugger->GetEmulator();
+	PpuFrameInfo frame = emu->GetPpuFrame();
+	if(!frame.FrameBuffer)
+		return;
+
+	uint32_t* rgbBuffer = nullptr;
+	FrameInfo rgbSize = {};
+
+	for(ScreenRegistry& reg : _screenMemory) {
+		if(reg.Format == PythonScreenFormat::Raw) {
+			// Raw PPU output, no filtering needed
+			if(UpdateScreenBufferSize(reg, frame.Width, frame.Height))
+				memcpy(reg.Buffer->Data, frame.FrameBuffer, std::min<size_t>(reg.Buffer->Size, frame.FrameBufferSize));
+			continue;
+		}
+
+		if(!rgbBuffer) {
+			// The filter is kept until the video filter or console changes (like VideoDecoder), it only reallocates its output buffer when the frame's size changes
+			VideoFilterType filterType = _settings->GetVideoConfig().VideoFilter;
+			ConsoleType consoleType = emu->GetConsoleType();
+			if(!_screenFilter || _screenFilterType != filterType || _screenFilterConsoleType != consoleType) {
+				_screenFilter.reset(emu->GetVideoFilter());
+				_screenFilterType = filterType;
+				_screenFilterConsoleType = consoleType;
+			}
+
+			_screenFilter->SetBaseFrameInfo({ frame.Width, frame.Height });
+			rgbSize = _screenFilter->SendFrame((uint16_t*)frame.FrameBuffer, emu->GetFrameCount(), emu->GetFrameCount() & 0x01, nullptr, false);
+			rgbBuffer = _screenFilter->GetOutputBuffer();
+		}
 
-		unique_ptr<BaseVideoFilter> filter(_emu->GetVideoFilter());
-		filter->SetBaseFrameInfo(frameSize);
-		frameSize = filter->SendFrame((uint16_t*)frame.FrameBuffer, _emu->GetFrameCount(), _emu->GetFrameCount() & 0x01, nullptr, false);
-		uint32_t* rgbBuffer = filter->GetOutputBuffer();
-		memcpy_s(_frameBuffer, sizeof(_frameBuffer), rgbBuffer, frameSize.Height * frameSize.Width * sizeof(uint32_t));
+		if(!UpdateScreenBufferSize(reg, rgbSize.Width, rgbSize.Height))
+			continue;
+
+		if(reg.Format == PythonScreenFormat::Rgb) {
+			memcpy(reg.Buffer->Data, rgbBuffer, reg.Buffer->Size);
+		} else {
+			// Box filter over scale x scale pixels, using integer luma weights (77/150/29 = 0.299/0.587/0.114)
+			uint32_t scale = reg.Scale;
+			uint32_t width = (uint32_t)reg.Buffer->Shape[1];
+			uint32_t height = (uint32_t)reg.Buffer->Shape[0];
+			uint32_t pixelCount = scale * scale;
+			uint8_t* out = reg.Buffer->Data;
+			for(uint32_t y = 0; y < height; y++) {
+				for(uint32_t x = 0; x < width; x++) {
+					uint32_t sum = 0;
+					for(uint32_t i = 0; i < scale; i++) {
+						uint32_t* src = rgbBuffer + (y * scale + i) * rgbSize.Width + x * scale;
+						for(uint32_t j = 0; j < scale; j++) {
+							uint32_t rgb = src[j];
+							sum += ((rgb >> 16) & 0xFF) * 77 + ((rgb >> 8) & 0xFF) * 150 + (rgb & 0xFF) * 29;
+						}
+					}
+					*out++ = (uint8_t)(sum / pixelCount >> 8);
+				}
+			}
+		}
 	}
 }
 
@@ -102,6 +288,22 @@ bool PythonScriptingContext::ReadMemory(uint32_t addr, MemoryType memType, bool
 	return true;
 }
 
+void PythonScriptingContext::ReadMemoryRange(MemoryType type, uint32_t start, uint32_t length, uint8_t* output)
+{
+	uint32_t size = _memoryDumper->GetMemorySize(type);
+	uint32_t available = start < size ? std::min(length, size - start) : 0;
+
+	ConsoleMemoryInfo memory = _debugger->GetEmulator()->GetMemory(type);
+	if(available > 0 && !DebugUtilities::IsRelativeMemory(type) && memory.Memory) {
+		memcpy(output, (uint8_t*)memory.Memory + start, available);
+	} else if(available > 0) {
+		_memoryDumper->GetMemoryValues(type, start, start + available - 1, output);
+	}
+
+	//Addresses past the end of the memory read as 0, like read8
+	memset(output + available, 0, length - available);
+}
+
 PythonScriptingContext::PythonScriptingContext(Debugger* debugger)
 {
 	_debugger = debugger;
@@ -187,36 +389,133 @@ string PythonScriptingContext::GetScriptName()
 	return _scriptName;
 }
 
-void PythonScriptingContext::CallMemoryCallback(AddressInfo relAddr, uint8_t& value, CallbackType type, CpuType cpuType)
+void PythonScriptingContext::ProcessPendingStates(CallbackType type, CpuType cpuType)
 {
-	if(!_loadSaveState.empty()) {
-		_debugger->GetScriptManager()->DisableCpuMemoryCallbacks();
-		_debugger->GetEmulator()->GetSaveStateManager()->LoadState(_loadSaveState);
+	//Save states can only be saved/loaded between 2 instructions of the main CPU
+	if(type != CallbackType::Exec || cpuType != _defaultCpuType) {
+		return;
+	}
+
+	if(_pendingSnapshots.empty() && !_loadSnapshot && _loadSaveState.empty()) {
+		return;
+	}
+
+	Emulator* emu = _debugger->GetEmulator();
+	for(shared_ptr<StateSnapshot>& snapshot : _pendingSnapshots) {
+		snapshot->State = emu->GetSaveStateManager()->SaveSnapshot();
+	}
+	_pendingSnapshots.clear();
+
+	if(_loadSnapshot) {
+		shared_ptr<StateSnapshot> snapshot = _loadSnapshot;
+		_loadSnapshot.reset();
+		if(snapshot->State && emu->GetSaveStateManager()->LoadSnapshot(*snapshot->State)) {
+			emu->ProcessEvent(EventType::StateLoaded);
+		}
+	} else if(!_loadSaveState.empty()) {
+		string path = _loadSaveState;
 		_loadSaveState.clear();
+		emu->GetSaveStateManager()->LoadState(path);
 	}
+
+	//Disable the CPU memory callbacks unless a script still needs them
+	_debugger->GetScriptManager()->RefreshMemoryCallbackFlags();
 }
 
-void PythonScriptingContext::CallMemoryCallback(AddressInfo relAddr, uint16_t& value, CallbackType type, CpuType cpuType)
+template<typename T>
+void PythonScriptingContext::InternalCallMemoryCallback(AddressInfo relAddr, T& value, CallbackType type, CpuType cpuType)
 {
-	if(!_loadSaveState.empty()) {
-		_debugger->GetScriptManager()->DisableCpuMemoryCallbacks();
-		_debugger->GetEmulator()->GetSaveStateManager()->LoadState(_loadSaveState);
-		_loadSaveState.clear();
+	ProcessPendingStates(type, cpuType);
+
+	int typeIndex = (int)type;
+	if(_relativeCallbackCount[typeIndex] > 0 && relAddr.Address >= 0) {
+		CallMatchingCallbacks(_memoryCallbacks[typeIndex][(int)relAddr.Type].Find(relAddr.Address), relAddr, value, cpuType);
+	}
+
+	if(_absoluteCallbackCount[typeIndex] > 0) {
+		//Only resolve the absolute address when callbacks were registered on absolute memory types
+		AddressInfo absAddr = _debugger->GetAbsoluteAddress(relAddr);
+		if(absAddr.Address >= 0) {
+			CallMatchingCallbacks(_memoryCallbacks[typeIndex][(int)absAddr.Type].Find(absAddr.Address), relAddr, value, cpuType);
+		}
 	}
 }
 
-void PythonScriptingContext::CallMemoryCallback(AddressInfo relAddr, uint32_t& value, CallbackType type, CpuType cpuType)
+template<typename T>
+void PythonScriptingContext::CallMatchingCallbacks(const vector<PythonMemoryCallback>* callbacks, AddressInfo relAddr, T& value, CpuType cpuType)
 {
-	if(!_loadSaveState.empty()) {
-		_debugger->GetScriptManager()->DisableCpuMemoryCallbacks();
-		_debugger->GetEmulator()->GetSaveStateManager()->LoadState(_loadSaveState);
-		_loadSaveState.clear();
+	if(!callbacks) {
+		return;
+	}
+
+	auto lock = _python.AcquireSafe();
+
+	//Callbacks can add/remove memory callbacks, which rebuilds the index - iterate on a copy
+	//A reference is kept on each callback until the loop ends, in case an earlier callback unregisters a later one
+	_matchingCallbacks.assign(callbacks->begin(), callbacks->end());
+	for(PythonMemoryCallback& callback : _matchingCallbacks) {
+		Py_INCREF(callback.Callback);
+	}
+
+	for(PythonMemoryCallback& callback : _matchingCallbacks) {
+		if(callback.Cpu != cpuType) {
+			continue;
+		}
+
+		PyObject* args = Py_BuildValue("(iI)", relAddr.Address, (uint32_t)value);
+		PyObject* result = PyObject_CallObject(callback.Callback, args);
+		Py_DECREF(args);
+		if(result != nullptr) {
+			//Returning an integer overrides the value read/written
+			if(PyLong_Check(result)) {
+				value = (T)PyLong_AsUnsignedLongMask(result);
+			}
+			Py_DECREF(result);
+		} else {
+			LogError();
+		}
+	}
+
+	for(PythonMemoryCallback& callback : _matchingCallbacks) {
+		Py_DECREF(callback.Callback);
 	}
 }
 
+void PythonScriptingContext::CallMemoryCallback(AddressInfo relAddr, uint8_t& value, CallbackType type, CpuType cpuType)
+{
+	InternalCallMemoryCallback(relAddr, value, type, cpuType);
+}
+
+void PythonScriptingContext::CallMemoryCallback(AddressInfo relAddr, uint16_t& value, CallbackType type, CpuType cpuType)
+{
+	InternalCallMemoryCallback(relAddr, value, type, cpuType);
+}
+
+void PythonScriptingContext::CallMemoryCallback(AddressInfo relAddr, uint32_t& value, CallbackType type, CpuType cpuType)
+{
+	InternalCallMemoryCallback(relAddr, value, type, cpuType);
+}
+
 void PythonScriptingContext::LoadSaveState(const string& path)
 {
 	_loadSaveState = path;
+	_loadSnapshot.reset();
+	_debugger->GetScriptManager()->EnableCpuMemoryCallbacks();
+}
+
+shared_ptr<PythonScriptingContext::StateSnapshot> PythonScriptingContext::SaveSnapshot()
+{
+	//The state is saved at the start of the next instruction, the snapshot is empty until then
+	shared_ptr<StateSnapshot> snapshot(new StateSnapshot());
+	_pendingSnapshots.push_back(snapshot);
+	_debugger->GetScriptManager()->EnableCpuMemoryCallbacks();
+	return snapshot;
+}
+
+void PythonScriptingContext::LoadSnapshot(shared_ptr<StateSnapshot> snapshot)
+{
+	_loadSnapshot = snapshot;
+	_loadSaveState.clear();
 	_debugger->GetScriptManager()->EnableCpuMemoryCallbacks();
 }
 
@@ -225,7 +524,10 @@ int PythonScriptingContext::CallEventCallback(EventType type, CpuType cpuType)
 	if(type == EventType::StartFrame && _needsInit) {
 		_needsInit = false;
 		PyThreadState* state = InitializePython(this, GetDirectoryFromPath(_scriptPath));
-		_python = PythonInterpreterHandler(state);
+		if(!state) {
+			Log("Could not create the script's python interpreter.");
+		}
+		_python.Attach(state);
 
 		auto lock = _python.AcquireSafe();
 
@@ -236,6 +538,11 @@ int PythonScriptingContext::CallEventCallback(EventType type, CpuType cpuType)
 	}
 
 	if(type == EventType::ScriptEnded) {
+		{
+			auto lock = _python.AcquireSafe();
+			ReleaseMemoryBuffers();
+			ReleaseMemoryCallbacks();
+		}
 		_python.Detach();
 		return 0;
 	}
@@ -279,15 +586,75 @@ bool PythonScriptingContext::IsSaveStateAllowed()
 
 
 void PythonScriptingContext::RefreshMemoryCallbackFlags()
-{}
+{
+	if(!_pendingSnapshots.empty() || _loadSnapshot || !_loadSaveState.empty()) {
+		_debugger->GetScriptManager()->EnableCpuMemoryCallbacks();
+	}
+
+	for(int i = (int)CallbackType::Read; i <= (int)CallbackType::Exec; i++) {
+		for(int j = 0; j < DebugUtilities::GetMemoryTypeCount(); j++) {
+			if(!_memoryCallbacks[i][j].IsEmpty()) {
+				if(DebugUtilities::IsPpuMemory((MemoryType)j)) {
+					_debugger->GetScriptManager()->EnablePpuMemoryCallbacks();
+				} else {
+					_debugger->GetScriptManager()->EnableCpuMemoryCallbacks();
+				}
+			}
+		}
+	}
+}
 
 void PythonScriptingContext::RegisterMemoryCallback(CallbackType type, int startAddr, int endAddr, MemoryType memType, CpuType cpuType, PyObject* obj)
 {
+	if(endAddr < startAddr || startAddr < 0) {
+		return;
+	}
+
+	Py_INCREF(obj);
+	_memoryCallbacks[(int)type][(int)memType].Add((uint32_t)startAddr, (uint32_t)endAddr, { obj, cpuType });
+	if(DebugUtilities::IsRelativeMemory(memType)) {
+		_relativeCallbackCount[(int)type]++;
+	} else {
+		_absoluteCallbackCount[(int)type]++;
+	}
 
+	if(DebugUtilities::IsPpuMemory(memType)) {
+		_debugger->GetScriptManager()->EnablePpuMemoryCallbacks();
+	} else {
+		_debugger->GetScriptManager()->EnableCpuMemoryCallbacks();
+	}
 }
-void PythonScriptingContext::UnregisterMemoryCallback(CallbackType type, int startAddr, int endAddr, MemoryType memType, CpuType cpuType, PyObject* obj)
+
+bool PythonScriptingContext::UnregisterMemoryCallback(CallbackType type, int startAddr, int endAddr, MemoryType memType, CpuType cpuType, PyObject* obj)
 {
+	if(endAddr < startAddr || startAddr < 0) {
+		return false;
+	}
 
+	if(!_memoryCallbacks[(int)type][(int)memType].Remove((uint32_t)startAddr, (uint32_t)endAddr, { obj, cpuType })) {
+		return false;
+	}
+
+	if(DebugUtilities::IsRelativeMemory(memType)) {
+		_relativeCallbackCount[(int)type]--;
+	} else {
+		_absoluteCallbackCount[(int)type]--;
+	}
+
+	Py_DECREF(obj);
+	return true;
+}
+
+void PythonScriptingContext::ReleaseMemoryCallbacks()
+{
+	for(int i = (int)CallbackType::Read; i <= (int)CallbackType::Exec; i++) {
+		for(int j = 0; j < DebugUtilities::GetMemoryTypeCount(); j++) {
+			_memoryCallbacks[i][j].ForEachValue([](PythonMemoryCallback& callback) { Py_DECREF(callback.Callback); });
+			_memoryCallbacks[i][j].Clear();
+		}
+		_relativeCallbackCount[i] = 0;
+		_absoluteCallbackCount[i] = 0;
+	}
 }
 void PythonScriptingContext::RegisterEventCallback(EventType type, PyObject* obj)
 {
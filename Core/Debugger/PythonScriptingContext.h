@@ -2,6 +2,10 @@
 #include "pch.h"
 
 #include "ScriptingContext.h"
+#include "Debugger/DebugUtilities.h"
+#include "Debugger/AddressIntervalIndex.h"
+#include "Utilities/SimpleLock.h"
+#include "Shared/SettingTypes.h"
 
 #ifdef _WIN32
 /* struct timeval */
@@ -20,11 +24,18 @@
 #endif
 
 
+//Makes a script's interpreter active on the current thread and holds its GIL until destroyed.
+//The GIL is only held while python code runs (callbacks, api calls, etc.) - the emulation itself
+//runs without it, which lets several emulator instances run in parallel in the same process.
 class PythonInterpreterHolder
 {
 private:
+	//Thread state that is active (holding the GIL) on the current thread, if any
+	static inline thread_local PyThreadState* _current = nullptr;
+
 	volatile LONG* _count = nullptr;
-	PyThreadState* _old = nullptr;
+	PyThreadState* _state = nullptr;
+	PyThreadState* _previous = nullptr;
 
 public:
 	PythonInterpreterHolder(PyThreadState* state, volatile LONG* count)
@@ -33,64 +44,77 @@ public:
 		{
 			_count = count;
 			InterlockedIncrement(_count);
-			if (state)
-				_old = PyThreadState_Swap(state);
+			if(_current != state) {
+				//Another script's interpreter can be active when its callbacks trigger this one (e.g loading a state)
+				_previous = Suspend();
+				PyEval_RestoreThread(state);
+				_current = state;
+				_state = state;
+			}
 		}
 	}
 
 	PythonInterpreterHolder(PythonInterpreterHolder&& other)
 	{
 		_count = other._count;
-		_old = other._old;
+		_state = other._state;
+		_previous = other._previous;
 
 		other._count = nullptr;
-		other._old = nullptr;
+		other._state = nullptr;
+		other._previous = nullptr;
 	}
 
 	~PythonInterpreterHolder()
 	{
-		if (_old)
-			PyThreadState_Swap(_old);
+		if(_state) {
+			PyEval_SaveThread();
+			_current = nullptr;
+			Resume(_previous);
+		}
 
 		if(_count)
 			InterlockedDecrement(_count);
 	}
+
+	//Releases the GIL of the interpreter active on this thread (if any), returns its thread state
+	static PyThreadState* Suspend()
+	{
+		PyThreadState* current = _current;
+		if(current) {
+			PyEval_SaveThread();
+			_current = nullptr;
+		}
+		return current;
+	}
+
+	static void Resume(PyThreadState* state)
+	{
+		if(state) {
+			PyEval_RestoreThread(state);
+			_current = state;
+		}
+	}
 };
 
+//Owns a script's sub-interpreter. Thread states are bound to the thread that created them, so each
+//thread that runs the script's code (emulation thread, step mode caller, UI thread, etc.) gets its own.
 class PythonInterpreterHandler
 {
 private:
-	PyThreadState* _python = nullptr;
+	PyInterpreterState* _interpreter = nullptr;
+	vector<std::pair<std::thread::id, PyThreadState*>> _threadStates;
+	SimpleLock _stateLock;
 	volatile LONG _count = 0;
 
+	PyThreadState* GetThreadState();
+
 public:
 	PythonInterpreterHandler() {}
-	PythonInterpreterHandler(PyThreadState* python) { _python = python; }
 	PythonInterpreterHandler(PythonInterpreterHandler& other) = delete;
 
-	PythonInterpreterHandler& operator=(PythonInterpreterHandler&& other)
-	{
-		if(this != &other)
-		{
-			// Move the state from 'other' to 'this'
-			_python = other._python;
-			_count = other._count;
-
-			// Reset the state of 'other'
-			other._python = nullptr;
-			other._count = 0;
-		}
-		return *this;
-	}
-
-	void Detach()
-	{
-		if(_python)
-		{
-			Py_EndInterpreter(_python);
-			_python = nullptr;
-		}
-	}
+	void Attach(PyThreadState* state);
+	void Detach();
 
 	~PythonInterpreterHandler()
 	{
@@ -99,20 +123,74 @@ public:
 
 	PythonInterpreterHolder AcquireSafe()
 	{
-		return PythonInterpreterHolder(_python, &_count);
+		return PythonInterpreterHolder(GetThreadState(), &_count);
 	}
 
 	bool IsExecuting() { return _count > 0; }
 };
 
+class Serializer;
+class BaseVideoFilter;
+struct PythonMemoryBuffer;
+
+enum class PythonScreenFormat
+{
+	Rgb = 0, //Output of the video filter, height x width x 4 (BGRA) uint8
+	Raw = 1, //PPU output before filtering (e.g palette indexes for the NES), height x width uint16
+	Grayscale = 2 //Output of the video filter converted to grayscale and downscaled, (height / scale) x (width / scale) uint8
+};
+
 class PythonScriptingContext : public IScriptingContext
 {
+public:
+	struct StateSnapshot
+	{
+		unique_ptr<Serializer> State;
+	};
+
 protected:
+	//Contiguous run of registered addresses copied straight from the console's memory
+	struct FrameMemoryCopy
+	{
+		uint8_t* Source;
+		uint32_t Offset;
+		uint32_t Length;
+	};
+
+	//Registered address that can't be mapped to a fixed buffer (registers, banked memory, etc.)
+	struct FrameMemoryRead
+	{
+		uint32_t Offset;
+		uint32_t Address;
+	};
+
 	struct MemoryRegistry
 	{
+		PythonMemoryBuffer* Buffer;
 		uint8_t* BaseAddress;
 		MemoryType Type;
 		std::vector<int> Addresses;
+
+		//Scatter-gather plan built at registration
+		std::vector<FrameMemoryCopy> Copies;
+		std::vector<FrameMemoryRead> Reads;
+	};
+
+	struct ScreenBufferRef
+	{
+		PythonMemoryBuffer* Buffer;
+		int RegisterCount;
+	};
+
+	struct ScreenRegistry
+	{
+		PythonScreenFormat Format;
+		uint32_t Scale;
+		PythonMemoryBuffer* Buffer;
+		int RegisterCount;
+
+		//Buffers returned before the resolution changed, kept until the script unregisters them
+		std::vector<ScreenBufferRef> OldBuffers;
 	};
 
 
@@ -135,26 +213,60 @@ protected:
 
 	bool _allowSaveState = true;
 
+	string _loadSaveState;
+	shared_ptr<StateSnapshot> _loadSnapshot;
+	vector<shared_ptr<StateSnapshot>> _pendingSnapshots;
+
+	void ProcessPendingStates(CallbackType type, CpuType cpuType);
+
+	struct PythonMemoryCallback
+	{
+		PyObject* Callback;
+		CpuType Cpu;
+
+		bool operator==(const PythonMemoryCallback& other) const { return Callback == other.Callback && Cpu == other.Cpu; }
+	};
+
 	ScriptDrawSurface _drawSurface = ScriptDrawSurface::ConsoleScreen;
 	vector<PyObject*> _eventCallbacks[(int)EventType::LastValue + 1];
 
+	//Memory callbacks, indexed by callback type and memory type (relative or absolute)
+	AddressIntervalIndex<PythonMemoryCallback> _memoryCallbacks[3][DebugUtilities::GetMemoryTypeCount()];
+	uint32_t _relativeCallbackCount[3] = {};
+	uint32_t _absoluteCallbackCount[3] = {};
+	vector<PythonMemoryCallback> _matchingCallbacks;
+
+	template<typename T> void InternalCallMemoryCallback(AddressInfo relAddr, T& value, CallbackType type, CpuType cpuType);
+	template<typename T> void CallMatchingCallbacks(const vector<PythonMemoryCallback>* callbacks, AddressInfo relAddr, T& value, CpuType cpuType);
+	void ReleaseMemoryCallbacks();
+
 	void LogError();
 
 	std::vector<MemoryRegistry> _frameMemory;
-	uint32_t _frameBuffer[256 * 240];
-	int _frameBufferRegisterCount = 0;
+	std::vector<ScreenRegistry> _screenMemory;
+	unique_ptr<BaseVideoFilter> _screenFilter;
+	VideoFilterType _screenFilterType = {};
+	ConsoleType _screenFilterConsoleType = {};
 
+	uint8_t* GetFixedMemoryPointer(MemoryType type, uint32_t address);
+	void BuildFrameMemoryPlan(MemoryRegistry& reg);
 	void FillOneFrameMemory(const MemoryRegistry& reg);
 	void UpdateFrameMemory();
 	void UpdateScreenMemory();
+	bool UpdateScreenBufferSize(ScreenRegistry& reg, uint32_t width, uint32_t height);
+	void ReleaseMemoryBuffers();
 
 public:
 	// Python apis
 	bool ReadMemory(uint32_t addr, MemoryType mem, bool sgned, uint8_t& result);
-	void* RegisterFrameMemory(MemoryType type, const std::vector<int>& addresses);
+	void ReadMemoryRange(MemoryType type, uint32_t start, uint32_t length, uint8_t* output);
+	PyObject* RegisterFrameMemory(MemoryType type, const std::vector<int>& addresses);
 	bool UnregisterFrameMemory(void* ptr);
-	void *RegisterScreenMemory();
+	PyObject* RegisterScreenMemory(PythonScreenFormat format, uint32_t scale);
 	bool UnregisterScreenMemory(void *ptr);
+	void LoadSaveState(const string& path);
+	shared_ptr<StateSnapshot> SaveSnapshot();
+	void LoadSnapshot(shared_ptr<StateSnapshot> snapshot);
 
 public:
 	PythonScriptingContext(Debugger* debugger);
@@ -184,7 +296,7 @@ public:
 	void RefreshMemoryCallbackFlags() override;
 
 	void RegisterMemoryCallback(CallbackType type, int startAddr, int endAddr, MemoryType memType, CpuType cpuType, PyObject* obj);
-	void UnregisterMemoryCallback(CallbackType type, int startAddr, int endAddr, MemoryType memType, CpuType cpuType, PyObject* obj);
+	bool UnregisterMemoryCallback(CallbackType type, int startAddr, int endAddr, MemoryType memType, CpuType cpuType, PyObject* obj);
 	void RegisterEventCallback(EventType type, PyObject* obj);
 	void UnregisterEventCallback(EventType type, PyObject* obj);
 };
@@ -6,6 +6,7 @@
 #include "Shared/Emulator.h"
 #include "Shared/Video/DebugHud.h"
 #include "Shared/MemoryOperationType.h"
+#include "Shared/PerfCounters.h"
 
 ScriptManager::ScriptManager(Debugger* debugger)
 {
@@ -83,6 +84,7 @@ string ScriptManager::GetScriptLog(int32_t scriptId)
 
 void ScriptManager::ProcessEvent(EventType type, CpuType cpuType)
 {
+	PerfTimer timer(_debugger->GetEmulator()->GetPerfCounters(), PerfCounterType::ScriptEvent);
 	for(unique_ptr<ScriptHost> &script : _scripts) {
 		script->ProcessEvent(type, cpuType);
 	}
@@ -18,8 +18,6 @@ private:
 	bool _isCpuMemoryCallbackEnabled = false;
 	bool _isPpuMemoryCallbackEnabled = false;
 	vector<unique_ptr<ScriptHost>> _scripts;
-	
-	void RefreshMemoryCallbackFlags();
 
 public:
 	ScriptManager(Debugger *debugger);
@@ -30,6 +28,7 @@ public:
 	void RemoveScript(int32_t scriptId);
 	string GetScriptLog(int32_t scriptId);
 	void ProcessEvent(EventType type, CpuType cpuType);
+	void RefreshMemoryCallbackFlags();
 
 	void EnableCpuMemoryCallbacks() { _isCpuMemoryCallbackEnabled = true; }
 	void DisableCpuMemoryCallbacks() { _isCpuMemoryCallbackEnabled = false; }
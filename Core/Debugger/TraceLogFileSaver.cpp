@@ -0,0 +1,222 @@
+#include "pch.h"
+#include "Debugger/TraceLogFileSaver.h"
+#include "Utilities/CompressionHelper.h"
+
+void TraceLogFileSaver::StartLogging(string filename)
+{
+	StopLogging();
+
+	_outputBuffer.clear();
+	_outputFile.open(filename, ios::out | ios::binary);
+	_binaryMode = false;
+	_enabled = true;
+}
+
+void TraceLogFileSaver::StartBinaryLogging(string filename, uint64_t maxFileSize, uint32_t consoleType, uint16_t rowSizes[BinaryTraceFileHeader::MaxCpuTypes])
+{
+	StopLogging();
+
+	_outputFile.open(filename, ios::out | ios::binary);
+	if(!_outputFile) {
+		return;
+	}
+
+	_consoleType = consoleType;
+	memcpy(_rowSizes, rowSizes, sizeof(_rowSizes));
+	_maxFileSize = maxFileSize;
+	_writePos = sizeof(BinaryTraceFileHeader);
+	_blockId = 0;
+	_blocks.clear();
+	_wrapped = false;
+	_wrapOffset = 0;
+	WriteFileHeader();
+
+	_blockBuffer.clear();
+	_blockBuffer.reserve(BinaryBlockSize);
+	_stopWriter = false;
+	_writerThread = std::thread(&TraceLogFileSaver::WriterLoop, this);
+
+	_binaryMode = true;
+	_enabled = true;
+}
+
+void TraceLogFileSaver::StopLogging()
+{
+	if(_enabled) {
+		_enabled = false;
+		if(_binaryMode) {
+			//Write the last (partial) block and let the writer thread empty its queue
+			QueueBlock();
+			{
+				std::unique_lock<std::mutex> lock(_queueLock);
+				_stopWriter = true;
+			}
+			_queueSignal.notify_all();
+			_writerThread.join();
+			_binaryMode = false;
+		} else if(_outputFile && !_outputBuffer.empty()) {
+			_outputFile << _outputBuffer;
+		}
+		_outputFile.close();
+	}
+}
+
+void TraceLogFileSaver::QueueBlock()
+{
+	if(_blockBuffer.empty()) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_queueLock);
+	//Wait for the writer thread to catch up rather than dropping rows (or using an unbounded amount of memory)
+	_queueSignal.wait(lock, [this] { return _pendingBlocks.size() < MaxPendingBlocks; });
+	_pendingBlocks.emplace_back(std::move(_blockBuffer));
+	lock.unlock();
+	_queueSignal.notify_all();
+
+	_blockBuffer = vector<uint8_t>();
+	_blockBuffer.reserve(BinaryBlockSize);
+}
+
+void TraceLogFileSaver::WriterLoop()
+{
+	while(true) {
+		vector<uint8_t> block;
+		{
+			std::unique_lock<std::mutex> lock(_queueLock);
+			_queueSignal.wait(lock, [this] { return _stopWriter || !_pendingBlocks.empty(); });
+			if(_pendingBlocks.empty()) {
+				//Stop requested and all blocks have been written
+				break;
+			}
+			block = std::move(_pendingBlocks.front());
+			_pendingBlocks.pop_front();
+		}
+		_queueSignal.notify_all();
+
+		WriteBlock(block);
+	}
+	_outputFile.flush();
+}
+
+void TraceLogFileSaver::WriteBlock(vector<uint8_t>& block)
+{
+	vector<uint8_t> compressedData;
+	CompressionHelper::Compress(block.data(), (uint32_t)block.size(), CompressionType::Fast, 1, compressedData);
+
+	BinaryTraceBlockHeader blockHeader = { BlockMagic, _blockId++, (uint32_t)compressedData.size() };
+	uint64_t size = sizeof(blockHeader) + compressedData.size();
+
+	if(_maxFileSize > 0 && _writePos + size > _maxFileSize && _writePos > sizeof(BinaryTraceFileHeader)) {
+		//File is full, wrap around and start overwriting the oldest blocks
+		//Blocks from the previous pass that are past the new wrap offset can no longer be read, forget about them
+		while(!_blocks.empty() && _blocks.front().Offset >= _writePos) {
+			_blocks.pop_front();
+		}
+		_wrapped = true;
+		_wrapOffset = _writePos;
+		_writePos = sizeof(BinaryTraceFileHeader);
+	}
+
+	if(_wrapped) {
+		//Forget about the old blocks that are about to be (partially) overwritten
+		while(!_blocks.empty() && _blocks.front().Offset >= _writePos && _blocks.front().Offset < _writePos + size) {
+			_blocks.pop_front();
+		}
+		if(_blocks.empty() || _blocks.front().Offset < _writePos) {
+			//All blocks from the previous pass have been overwritten
+			_wrapped = false;
+			_wrapOffset = 0;
+		}
+	}
+
+	_outputFile.seekp(_writePos);
+	_outputFile.write((char*)&blockHeader, sizeof(blockHeader));
+	_outputFile.write((char*)compressedData.data(), compressedData.size());
+	_blocks.push_back({ _writePos, size });
+	_writePos += size;
+
+	//Update the header after the block is written, so the file stays readable if the process ends abruptly
+	WriteFileHeader();
+}
+
+void TraceLogFileSaver::WriteFileHeader()
+{
+	BinaryTraceFileHeader header = {};
+	memcpy(header.Magic, "MTRC", 4);
+	header.Version = BinaryFormatVersion;
+	header.ConsoleType = _consoleType;
+	memcpy(header.RowSizes, _rowSizes, sizeof(header.RowSizes));
+	header.FirstBlockOffset = _blocks.empty() ? sizeof(BinaryTraceFileHeader) : _blocks.front().Offset;
+	header.WrapOffset = _wrapped ? _wrapOffset : 0;
+	header.EndOffset = _writePos;
+
+	_outputFile.seekp(0);
+	_outputFile.write((char*)&header, sizeof(header));
+	_outputFile.seekp(_writePos);
+}
+
+bool TraceLogFileSaver::ReadBinaryLogHeader(string filename, BinaryTraceFileHeader& header)
+{
+	ifstream file(filename, ios::in | ios::binary);
+	if(!file) {
+		return false;
+	}
+
+	header = {};
+	file.read((char*)&header, sizeof(header));
+	return file && memcmp(header.Magic, "MTRC", 4) == 0 && header.Version == BinaryFormatVersion;
+}
+
+bool TraceLogFileSaver::ReadBinaryLog(string filename, std::function<void(CpuType cpuType, uint8_t* rowData, uint16_t rowSize)> callback)
+{
+	ifstream file(filename, ios::in | ios::binary);
+	if(!file) {
+		return false;
+	}
+
+	BinaryTraceFileHeader header = {};
+	file.read((char*)&header, sizeof(header));
+	if(!file || memcmp(header.Magic, "MTRC", 4) != 0 || header.Version != BinaryFormatVersion) {
+		return false;
+	}
+
+	auto readBlocks = [&](uint64_t start, uint64_t end) {
+		vector<uint8_t> compressedData;
+		vector<uint8_t> rows;
+		uint64_t pos = start;
+		while(pos + sizeof(BinaryTraceBlockHeader) <= end) {
+			BinaryTraceBlockHeader blockHeader = {};
+			file.seekg(pos);
+			file.read((char*)&blockHeader, sizeof(blockHeader));
+			if(!file || blockHeader.Magic != BlockMagic || pos + sizeof(blockHeader) + blockHeader.DataSize > end) {
+				return false;
+			}
+
+			compressedData.resize(blockHeader.DataSize);
+			file.read((char*)compressedData.data(), blockHeader.DataSize);
+			if(!file || !CompressionHelper::Decompress(compressedData, rows)) {
+				return false;
+			}
+
+			for(size_t i = 0; i + 3 <= rows.size();) {
+				uint16_t rowSize = rows[i + 1] | (rows[i + 2] << 8);
+				if(i + 3 + rowSize > rows.size()) {
+					return false;
+				}
+				callback((CpuType)rows[i], rows.data() + i + 3, rowSize);
+				i += 3 + rowSize;
+			}
+
+			pos += sizeof(blockHeader) + blockHeader.DataSize;
+		}
+		return true;
+	};
+
+	if(header.WrapOffset) {
+		//The oldest blocks are located after the most recent ones
+		return readBlocks(header.FirstBlockOffset, header.WrapOffset) && readBlocks(sizeof(BinaryTraceFileHeader), header.EndOffset);
+	} else {
+		return readBlocks(header.FirstBlockOffset, header.EndOffset);
+	}
+}
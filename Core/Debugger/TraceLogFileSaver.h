@@ -1,41 +1,93 @@
 #pragma once
 #include "pch.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "Shared/CpuType.h"
+
+//Binary trace logs contain the raw CPU/PPU state of each logged instruction, which is much faster
+//to log than formatting each row as text - the file is converted to the text format afterwards.
+//File format: BinaryTraceFileHeader, followed by blocks (BinaryTraceBlockHeader + CompressionHelper data)
+//Each block contains rows in this format: uint8 cpu type, uint16 row size, row data (see BaseTraceLogger)
+//When a max file size is set, the file is used as a ring buffer: once it is full, the oldest blocks are overwritten.
+//Rows are raw structs, so the header records the console type and each CPU's row size to reject files that don't match the current build/game.
+struct BinaryTraceFileHeader
+{
+	static constexpr int MaxCpuTypes = 16;
+
+	char Magic[4];
+	uint32_t Version;
+	uint32_t ConsoleType;
+	uint16_t RowSizes[MaxCpuTypes]; //Size of each CPU type's rows, 0 for CPU types that aren't available
+	uint64_t FirstBlockOffset; //Offset of the oldest block in the file
+	uint64_t WrapOffset; //End of the oldest blocks when the file has wrapped around (0 otherwise)
+	uint64_t EndOffset; //End of the most recent block
+};
+static_assert(CpuTypeUtilities::GetCpuTypeCount() <= BinaryTraceFileHeader::MaxCpuTypes, "CPU type count too large");
+
+struct BinaryTraceBlockHeader
+{
+	uint32_t Magic;
+	uint32_t BlockId;
+	uint32_t DataSize;
+};
 
 class TraceLogFileSaver
 {
 private:
+	static constexpr uint32_t BinaryFormatVersion = 2;
+	static constexpr uint32_t BlockMagic = 0x4B4C4254; //"TBLK"
+	static constexpr uint32_t BinaryBlockSize = 256 * 1024;
+	static constexpr uint32_t MaxPendingBlocks = 32;
+
+	struct BlockLocation
+	{
+		uint64_t Offset;
+		uint64_t Size;
+	};
+
 	bool _enabled = false;
+	bool _binaryMode = false;
 	string _outputFilepath;
 	string _outputBuffer;
 	ofstream _outputFile;
 
+	vector<uint8_t> _blockBuffer;
+	std::thread _writerThread;
+	std::mutex _queueLock;
+	std::condition_variable _queueSignal;
+	std::deque<vector<uint8_t>> _pendingBlocks;
+	bool _stopWriter = false;
+
+	uint32_t _consoleType = 0;
+	uint16_t _rowSizes[BinaryTraceFileHeader::MaxCpuTypes] = {};
+
+	//Only used by the writer thread
+	uint64_t _maxFileSize = 0;
+	uint64_t _writePos = 0;
+	uint32_t _blockId = 0;
+	std::deque<BlockLocation> _blocks;
+	bool _wrapped = false;
+	uint64_t _wrapOffset = 0;
+
+	void QueueBlock();
+	void WriterLoop();
+	void WriteBlock(vector<uint8_t>& block);
+	void WriteFileHeader();
+
 public:
 	~TraceLogFileSaver()
 	{
 		StopLogging();
 	}
 
-	void StartLogging(string filename)
-	{
-		_outputBuffer.clear();
-		_outputFile.open(filename, ios::out | ios::binary);
-		_enabled = true;
-	}
-
-	void StopLogging()
-	{
-		if(_enabled) {
-			_enabled = false;
-			if(_outputFile) {
-				if(!_outputBuffer.empty()) {
-					_outputFile << _outputBuffer;
-				}
-				_outputFile.close();
-			}
-		}
-	}
+	void StartLogging(string filename);
+	void StartBinaryLogging(string filename, uint64_t maxFileSize, uint32_t consoleType, uint16_t rowSizes[BinaryTraceFileHeader::MaxCpuTypes]);
+	void StopLogging();
 
 	__forceinline bool IsEnabled() { return _enabled; }
+	__forceinline bool IsBinaryMode() { return _binaryMode; }
 
 	void Log(string& log)
 	{
@@ -45,4 +97,25 @@ public:
 			_outputBuffer.clear();
 		}
 	}
-};
\ No newline at end of file
+
+	//Returns a buffer where the row's data (rowSize bytes) must be written
+	__forceinline uint8_t* ReserveBinaryRow(CpuType cpuType, uint16_t rowSize)
+	{
+		if(_blockBuffer.size() + rowSize + 3 > BinaryBlockSize) {
+			QueueBlock();
+		}
+
+		size_t pos = _blockBuffer.size();
+		_blockBuffer.resize(pos + rowSize + 3);
+		uint8_t* row = _blockBuffer.data() + pos;
+		row[0] = (uint8_t)cpuType;
+		row[1] = rowSize & 0xFF;
+		row[2] = rowSize >> 8;
+		return row + 3;
+	}
+
+	static bool ReadBinaryLogHeader(string filename, BinaryTraceFileHeader& header);
+
+	//Calls the callback for each row in the file, from oldest to newest
+	static bool ReadBinaryLog(string filename, std::function<void(CpuType cpuType, uint8_t* rowData, uint16_t rowSize)> callback);
+};
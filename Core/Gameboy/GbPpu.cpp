@@ -197,6 +197,7 @@ void GbPpu::ProcessVblankScanline()
 				_state.Ly = 0;
 				_state.LyForCompare = 0;
 				_wyEnableFlag = false;
+				UpdateSkipRender();
 
 				if(_emu->IsDebugging()) {
 					_emu->ProcessEvent(EventType::StartFrame, CpuType::Gameboy);
@@ -367,7 +368,8 @@ void GbPpu::RunDrawCycle()
 	}
 
 	if(_fetchSprite == -1 && _bgFifo.Size > 0) {
-		if(_drawnPixels >= 0) {
+		//The SGB's LCD buffer is always updated (it's read by the SNES side and is part of save states)
+		if(_drawnPixels >= 0 && (!_skipRender || _gameboy->IsSgb())) {
 			GameboyConfig& cfg = _emu->GetSettings()->GetGameboyConfig();
 
 			GbFifoEntry entry = _bgFifo.Content[_bgFifo.Position];
@@ -407,10 +409,18 @@ void GbPpu::RunDrawCycle()
 	ClockTileFetcher();
 }
 
+void GbPpu::UpdateSkipRender()
+{
+	//Pixels aren't drawn for run-ahead frames or when rendering is skipped (the pixel FIFOs and the SGB's LCD buffer still run normally)
+	_skipRender = _emu->IsRunAheadFrame() || _emu->IsRenderingSkipped();
+}
+
 void GbPpu::WriteBgPixel(uint8_t colorIndex)
 {
-	uint16_t outOffset = _state.Scanline * GbConstants::ScreenWidth + _drawnPixels;
-	_currentBuffer[outOffset] = _state.CgbBgPalettes[colorIndex] & 0x7FFF;
+	if(!_skipRender) {
+		uint16_t outOffset = _state.Scanline * GbConstants::ScreenWidth + _drawnPixels;
+		_currentBuffer[outOffset] = _state.CgbBgPalettes[colorIndex] & 0x7FFF;
+	}
 	if(_gameboy->IsSgb()) {
 		_gameboy->GetSgb()->WriteLcdColor(_state.Scanline, (uint8_t)_drawnPixels, colorIndex & 0x03);
 	}
@@ -418,8 +428,10 @@ void GbPpu::WriteBgPixel(uint8_t colorIndex)
 
 void GbPpu::WriteObjPixel(uint8_t colorIndex)
 {
-	uint16_t outOffset = _state.Scanline * GbConstants::ScreenWidth + _drawnPixels;
-	_currentBuffer[outOffset] = _state.CgbObjPalettes[colorIndex] & 0x7FFF;
+	if(!_skipRender) {
+		uint16_t outOffset = _state.Scanline * GbConstants::ScreenWidth + _drawnPixels;
+		_currentBuffer[outOffset] = _state.CgbObjPalettes[colorIndex] & 0x7FFF;
+	}
 	if(_gameboy->IsSgb()) {
 		_gameboy->GetSgb()->WriteLcdColor(_state.Scanline, (uint8_t)_drawnPixels, colorIndex & 0x03);
 	}
@@ -679,6 +691,7 @@ void GbPpu::SendFrame()
 	_isFirstFrame = false;
 
 	RenderedFrame frame(_currentBuffer, GbConstants::ScreenWidth, GbConstants::ScreenHeight, 1.0, _state.FrameCount, _gameboy->GetControlManager()->GetPortStates());
+	frame.RenderingSkipped = _skipRender;
 	bool rewinding = _emu->GetRewindManager()->IsRewinding();
 	_emu->GetVideoDecoder()->UpdateFrame(frame, rewinding, rewinding);
 
@@ -785,6 +798,7 @@ void GbPpu::Write(uint16_t addr, uint8_t value)
 					_state.Cycle = -1;
 					_state.IdleCycles = 0;
 					ResetRenderer();
+					UpdateSkipRender();
 					_state.LyCoincidenceFlag = _state.LyCompare == _state.LyForCompare;
 					UpdateStatIrq();
 					
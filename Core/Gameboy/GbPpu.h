@@ -51,7 +51,9 @@ private:
 
 	bool _isFirstFrame = true;
 	bool _rendererIdle = false;
+	bool _skipRender = false;
 
+	void UpdateSkipRender();
 	__forceinline void WriteBgPixel(uint8_t colorIndex);
 	__forceinline void WriteObjPixel(uint8_t colorIndex);
 
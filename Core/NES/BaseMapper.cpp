@@ -155,9 +155,7 @@ void BaseMapper::SetCpuMemoryMapping(uint16_t startAddr, uint16_t endAddr, uint8
 		return;
 	}
 
-	startAddr >>= 8;
-	endAddr >>= 8;
-	for(uint16_t i = startAddr; i <= endAddr; i++) {
+	for(uint16_t i = startAddr >> 8; i <= endAddr >> 8; i++) {
 		if(source && sourceSize > 0 && sourceOffset <= sourceSize - 0x100) {
 			_prgPages[i] = source + sourceOffset;
 			_prgMemoryAccess[i] = accessType != -1 ? (MemoryAccessType)accessType : MemoryAccessType::ReadWrite;
@@ -168,6 +166,37 @@ void BaseMapper::SetCpuMemoryMapping(uint16_t startAddr, uint16_t endAddr, uint8
 
 		sourceOffset += 0x100;
 	}
+
+	UpdateMemoryManagerPages(startAddr, endAddr);
+}
+
+void BaseMapper::UpdateMemoryManagerPages(uint16_t startAddr, uint16_t endAddr)
+{
+	//The memory manager keeps direct pointers to the prg pages, update them (it doesn't exist yet while the mapper is initialized)
+	NesMemoryManager* memoryManager = _console->GetMemoryManager();
+	if(memoryManager) {
+		memoryManager->UpdatePages(startAddr, endAddr);
+	}
+}
+
+uint8_t* BaseMapper::GetDirectPrgPage(uint8_t page, MemoryOperation operation)
+{
+	bool isRead = operation == MemoryOperation::Read;
+	if(!(isRead ? _allowDirectPrgRead : _allowDirectPrgWrite)) {
+		return nullptr;
+	}
+
+	if(!(_prgMemoryAccess[page] & (isRead ? MemoryAccessType::Read : MemoryAccessType::Write))) {
+		return nullptr;
+	}
+
+	//Pages that contain registers must go through ReadRam/WriteRam
+	bool* isRegisterAddr = isRead ? (_allowRegisterRead ? _isReadRegisterAddr : nullptr) : _isWriteRegisterAddr;
+	if(isRegisterAddr && memchr(isRegisterAddr + (page << 8), true, 0x100)) {
+		return nullptr;
+	}
+
+	return _prgPages[page];
 }
 
 void BaseMapper::RemoveCpuMemoryMapping(uint16_t startAddr, uint16_t endAddr)
@@ -508,6 +537,7 @@ void BaseMapper::AddRegisterRange(uint16_t startAddr, uint16_t endAddr, MemoryOp
 			_isWriteRegisterAddr[i] = true;
 		}
 	}
+	UpdateMemoryManagerPages(startAddr, endAddr);
 }
 
 void BaseMapper::RemoveRegisterRange(uint16_t startAddr, uint16_t endAddr, MemoryOperation operation)
@@ -520,6 +550,7 @@ void BaseMapper::RemoveRegisterRange(uint16_t startAddr, uint16_t endAddr, Memor
 			_isWriteRegisterAddr[i] = false;
 		}
 	}
+	UpdateMemoryManagerPages(startAddr, endAddr);
 }
 
 void BaseMapper::Serialize(Serializer& s)
@@ -591,6 +622,8 @@ void BaseMapper::Initialize(NesConsole* console, RomData& romData)
 	}
 
 	_allowRegisterRead = AllowRegisterRead();
+	_allowDirectPrgRead = AllowDirectPrgRead();
+	_allowDirectPrgWrite = AllowDirectPrgWrite();
 
 	memset(_isReadRegisterAddr, 0, sizeof(_isReadRegisterAddr));
 	memset(_isWriteRegisterAddr, 0, sizeof(_isWriteRegisterAddr));
@@ -25,6 +25,7 @@ private:
 	uint16_t InternalGetChrRomPageSize();
 	uint16_t InternalGetChrRamPageSize();
 	bool ValidateAddressRange(uint16_t startAddr, uint16_t endAddr);
+	void UpdateMemoryManagerPages(uint16_t startAddr, uint16_t endAddr);
 
 	uint8_t *_nametableRam = nullptr;
 	uint8_t _nametableCount = 2;
@@ -35,6 +36,8 @@ private:
 	bool _hasBusConflicts = false;
 	
 	bool _allowRegisterRead = false;
+	bool _allowDirectPrgRead = true;
+	bool _allowDirectPrgWrite = true;
 	bool _isReadRegisterAddr[0x10000] = {};
 	bool _isWriteRegisterAddr[0x10000] = {};
 
@@ -100,6 +103,11 @@ protected:
 	virtual uint16_t RegisterEndAddress() { return 0xFFFF; }
 	virtual bool AllowRegisterRead() { return false; }
 
+	//Mappers that override ReadRam/WriteRam to react to prg accesses must return false, otherwise the
+	//memory manager reads/writes the mapped prg memory directly, without calling ReadRam/WriteRam
+	virtual bool AllowDirectPrgRead() { return true; }
+	virtual bool AllowDirectPrgWrite() { return true; }
+
 	virtual uint32_t GetDipSwitchCount() { return 0; }
 	virtual uint32_t GetNametableCount() { return 0; }
 	
@@ -188,6 +196,7 @@ public:
 	void WriteRam(uint16_t addr, uint8_t value) override;
 	void DebugWriteRam(uint16_t addr, uint8_t value);
 	void WritePrgRam(uint16_t addr, uint8_t value);
+	uint8_t* GetDirectPrgPage(uint8_t page, MemoryOperation operation);
 
 	virtual uint8_t MapperReadVram(uint16_t addr, MemoryOperationType operationType);
 	
@@ -31,6 +31,7 @@ protected:
 	uint8_t _xScroll = 0;
 	bool _enableOamDecay = false;
 	bool _needStateUpdate = false;
+	bool _skipRender = false;
 	bool _renderingEnabled = false;
 	bool _prevRenderingEnabled = false;
 	//32
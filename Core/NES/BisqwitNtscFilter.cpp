@@ -4,6 +4,7 @@
 #include "pch.h"
 #include <cmath>
 #include "NES/BisqwitNtscFilter.h"
+#include "Utilities/RowBandThreadPool.h"
 #include "NES/NesPpu.h"
 #include "NES/NesConsole.h"
 #include "NES/NesDefaultVideoFilter.h"
@@ -12,8 +13,6 @@
 BisqwitNtscFilter::BisqwitNtscFilter(Emulator* emu) : BaseVideoFilter(emu)
 {
 	_resDivider = 1;
-	_stopThread = false;
-	_workDone = false;
 
 	// from https ://forums.nesdev.org/viewtopic.php?p=159266#p159266
 	const double signalLumaLow[2][4] = {
@@ -50,34 +49,10 @@ BisqwitNtscFilter::BisqwitNtscFilter(Emulator* emu) : BaseVideoFilter(emu)
 			_signalHigh[(h ? 0x40 : 0) | i] = int8_t(std::floor(((q - signal_blank) / (signal_white - signal_blank)) * 100));
 		}
 	}
-
-	_extraThread = std::thread([=]() {
-		//Worker thread to improve decode speed
-		while(!_stopThread) {
-			_waitWork.Wait();
-			if(_stopThread) {
-				break;
-			}
-
-			uint32_t* outputBuffer = GetOutputBuffer();
-			FrameInfo frameInfo = _frameInfo;
-
-			//Adjust outputbuffer to start at the middle of the picture
-			int scale = 8 / _resDivider;
-			outputBuffer += frameInfo.Width * ((120 - GetOverscan().Top) * scale);
-
-			DecodeFrame(120, 239 - GetOverscan().Bottom, _ppuOutputBuffer, outputBuffer, (GetVideoPhase() * 4) + 327360);
-
-			_workDone = true;
-		}
-	});
 }
 
 BisqwitNtscFilter::~BisqwitNtscFilter()
 {
-	_stopThread = true;
-	_waitWork.Signal();
-	_extraThread.join();
 }
 
 void BisqwitNtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
@@ -88,10 +63,17 @@ void BisqwitNtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 		NesDefaultVideoFilter::ApplyPalBorder(ppuOutputBuffer);
 	}
 
-	_workDone = false;
-	_waitWork.Signal();
-	DecodeFrame(GetOverscan().Top, 120, ppuOutputBuffer, GetOutputBuffer(), (GetVideoPhase() * 4) + GetOverscan().Top*341*8);
-	while(!_workDone) {}
+	int firstRow = GetOverscan().Top;
+	int lastRow = 239 - GetOverscan().Bottom;
+
+	//Decode all rows first (in parallel bands), then generate the lines between them - each
+	//generated line needs the next row, which can belong to another band
+	RowBandThreadPool::GetInstance().Run(lastRow - firstRow + 1, 16, [=](uint32_t startRow, uint32_t endRow) {
+		DecodeFrame(firstRow + startRow, firstRow + endRow - 1);
+	});
+	RowBandThreadPool::GetInstance().Run(lastRow - firstRow + 1, 16, [=](uint32_t startRow, uint32_t endRow) {
+		GenerateMissingLines(firstRow + startRow, firstRow + endRow - 1);
+	});
 }
 
 FrameInfo BisqwitNtscFilter::GetFrameInfo()
@@ -207,15 +189,21 @@ void BisqwitNtscFilter::GenerateNtscSignal(int8_t *ntscSignal, int &phase, int r
 	phase += (341 - 256) * _signalsPerPixel;
 }
 
-void BisqwitNtscFilter::DecodeFrame(int startRow, int endRow, uint16_t *ppuOutputBuffer, uint32_t* outputBuffer, int startPhase)
+uint32_t* BisqwitNtscFilter::GetRowOutputBuffer(int row)
+{
+	int pixelsPerCycle = 8 / _resDivider;
+	return GetOutputBuffer() + _frameInfo.Width * pixelsPerCycle * (row - GetOverscan().Top);
+}
+
+void BisqwitNtscFilter::DecodeFrame(int startRow, int endRow)
 {
 	int pixelsPerCycle = 8 / _resDivider;
-	int phase = startPhase;
+	//Each row is 341 pixels (8 signals per pixel) long, including hblank
+	int phase = (GetVideoPhase() * 4) + startRow * 341 * _signalsPerPixel;
 	constexpr int lineWidth = 256;
 	int8_t rowSignal[lineWidth * _signalsPerPixel];
 	uint32_t rowPixelGap = _frameInfo.Width * pixelsPerCycle;
-	
-	uint32_t* orgBuffer = outputBuffer;
+	uint32_t* outputBuffer = GetRowOutputBuffer(startRow);
 
 	for(int y = startRow; y <= endRow; y++) {
 		int startCycle = phase % 12;
@@ -228,9 +216,15 @@ void BisqwitNtscFilter::DecodeFrame(int startRow, int endRow, uint16_t *ppuOutpu
 
 		outputBuffer += rowPixelGap;
 	}
+}
+
+void BisqwitNtscFilter::GenerateMissingLines(int startRow, int endRow)
+{
+	int pixelsPerCycle = 8 / _resDivider;
+	uint32_t rowPixelGap = _frameInfo.Width * pixelsPerCycle;
+	uint32_t* outputBuffer = GetRowOutputBuffer(startRow);
 
 	//Generate the missing vertical lines
-	outputBuffer = orgBuffer;
 	int lastRow = 239 - GetOverscan().Bottom;
 	bool verticalBlend = false; //_emu->GetSettings()->GetVideoConfig();
 	for(int y = startRow; y <= endRow; y++) {
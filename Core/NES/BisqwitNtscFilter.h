@@ -4,7 +4,6 @@
 #pragma once
 #include "pch.h"
 #include "Shared/Video/BaseVideoFilter.h"
-#include "Utilities/AutoResetEvent.h"
 
 class BisqwitNtscFilter : public BaseVideoFilter
 {
@@ -13,11 +12,6 @@ private:
 	static constexpr int _signalsPerPixel = 8;
 	static constexpr int _signalWidth = 258;
 
-	std::thread _extraThread;
-	AutoResetEvent _waitWork;
-	atomic<bool> _stopThread;
-	atomic<bool> _workDone;
-
 	int _resDivider = 1;
 	uint16_t *_ppuOutputBuffer = nullptr;
 	
@@ -45,7 +39,9 @@ private:
 	void NtscDecodeLine(int width, const int8_t* signal, uint32_t* target, int phase0);
 	
 	void GenerateNtscSignal(int8_t *ntscSignal, int &phase, int rowNumber);
-	void DecodeFrame(int startRow, int endRow, uint16_t *ppuOutputBuffer, uint32_t* outputBuffer, int startPhase);
+	uint32_t* GetRowOutputBuffer(int row);
+	void DecodeFrame(int startRow, int endRow);
+	void GenerateMissingLines(int startRow, int endRow);
 	void OnBeforeApplyFilter();
 
 public:
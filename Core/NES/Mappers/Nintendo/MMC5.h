@@ -310,6 +310,7 @@ protected:
 	uint32_t GetWorkRamPageSize() override { return 0x2000; }
 	bool ForceSaveRamSize() override { return true; }
 	bool ForceWorkRamSize() override { return true; }
+	bool AllowDirectPrgWrite() override { return false; }
 
 	uint32_t GetSaveRamSize() override
 	{
@@ -38,6 +38,7 @@ private:
 protected:
 	uint16_t GetPrgPageSize() override { return 0x4000; }
 	uint16_t GetChrPageSize() override { return 0x800; }
+	bool AllowDirectPrgWrite() override { return false; }
 
 	void InitMapper() override
 	{
@@ -33,6 +33,18 @@ private:
 	INesMemoryHandler** _ramReadHandlers = nullptr;
 	INesMemoryHandler** _ramWriteHandlers = nullptr;
 
+	//Handler of each 256-byte page of the CPU's address space (nullptr when the page has more than one handler)
+	INesMemoryHandler* _readPageHandlers[0x100] = {};
+	INesMemoryHandler* _writePageHandlers[0x100] = {};
+
+	//Direct pointers to the memory mapped to each page, for pages that only contain internal ram or
+	//prg rom/ram - these are accessed without the handler's virtual call (nullptr = use the handler)
+	uint8_t* _readPages[0x100] = {};
+	uint8_t* _writePages[0x100] = {};
+
+	void UpdatePageHandlers();
+	uint8_t* GetDirectPage(INesMemoryHandler* handler, uint8_t page, MemoryOperation operation);
+
 	void InitializeMemoryHandlers(INesMemoryHandler** memoryHandlers, INesMemoryHandler* handler, vector<uint16_t>* addresses, bool allowOverride);
 
 protected:
@@ -46,6 +58,7 @@ public:
 	void RegisterIODevice(INesMemoryHandler* handler);
 	void RegisterWriteHandler(INesMemoryHandler* handler, uint32_t start, uint32_t end);
 	void UnregisterIODevice(INesMemoryHandler* handler);
+	void UpdatePages(uint16_t startAddr, uint16_t endAddr);
 
 	uint8_t DebugRead(uint16_t addr);
 	uint16_t DebugReadWord(uint16_t addr);
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "NES/NesNtscFilter.h"
+#include "Utilities/RowBandThreadPool.h"
 #include "NES/NesDefaultVideoFilter.h"
 #include "NES/NesConsole.h"
 #include "NES/NesPpu.h"
@@ -74,7 +75,13 @@ void NesNtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 		NesDefaultVideoFilter::ApplyPalBorder(ppuOutputBuffer);
 	}
 
-	nes_ntsc_blit(&_ntscData, ppuOutputBuffer, _baseFrameInfo.Width, GetVideoPhase(), _baseFrameInfo.Width, _baseFrameInfo.Height, _ntscBuffer, NES_NTSC_OUT_WIDTH(_baseFrameInfo.Width) * 4);
+	//Each row is filtered independently (the burst phase changes on every row), so the frame can be split in bands
+	uint32_t inWidth = _baseFrameInfo.Width;
+	uint32_t videoPhase = GetVideoPhase();
+	RowBandThreadPool::GetInstance().Run(_baseFrameInfo.Height, 16, [=](uint32_t startRow, uint32_t endRow) {
+		int burstPhase = (videoPhase + startRow) % nes_ntsc_burst_count;
+		nes_ntsc_blit(&_ntscData, ppuOutputBuffer + startRow * inWidth, inWidth, burstPhase, inWidth, endRow - startRow, _ntscBuffer + startRow * baseWidth, baseWidth * 4);
+	});
 
 	for(uint32_t i = 0; i < frameInfo.Height; i+=2) {
 		memcpy(GetOutputBuffer()+i*frameInfo.Width, _ntscBuffer + yOffset + xOffset + (i/2)*baseWidth, frameInfo.Width * sizeof(uint32_t));
@@ -854,6 +854,51 @@ template<class T> uint8_t NesPpu<T>::GetPixelColor()
 	return ((offset + ((_cycle - 1) & 0x07) < 8) ? _previousTilePalette : _currentTilePalette) + backgroundColor;
 }
 
+template<class T> bool NesPpu<T>::HasLightGun()
+{
+	BaseControlManager* controlManager = _console->GetControlManager();
+	return (
+		controlManager->HasControlDevice(ControllerType::NesZapper) ||
+		controlManager->HasControlDevice(ControllerType::FamicomZapper) ||
+		controlManager->HasControlDevice(ControllerType::BandaiHyperShot)
+	);
+}
+
+template<class T> void NesPpu<T>::ProcessSprite0Hit()
+{
+	//Used instead of DrawPixel when the frame isn't rendered - only checks for sprite 0 hit, with the same conditions as GetPixelColor
+	if(!_sprite0Visible || _statusFlags.Sprite0Hit || !_mask.BackgroundEnabled || _cycle == 256 || !_hasSprite[_cycle]) {
+		return;
+	}
+
+	if(_cycle <= _minimumDrawBgCycle || _cycle <= _minimumDrawSpriteCycle || _cycle <= _minimumDrawSpriteStandardCycle) {
+		return;
+	}
+
+	if(!IsRenderingEnabled() && (_videoRamAddr & 0x3F00) == 0x3F00) {
+		//DrawPixel doesn't call GetPixelColor in this case
+		return;
+	}
+
+	int32_t shift = (int32_t)_cycle - _spriteTiles[0].SpriteX - 1;
+	if(_spriteCount == 0 || shift < 0 || shift >= 8) {
+		return;
+	}
+
+	uint8_t spriteColor;
+	if(_spriteTiles[0].HorizontalMirror) {
+		spriteColor = ((_spriteTiles[0].LowByte >> shift) & 0x01) | ((_spriteTiles[0].HighByte >> shift) & 0x01) << 1;
+	} else {
+		spriteColor = ((_spriteTiles[0].LowByte << shift) & 0x80) >> 7 | ((_spriteTiles[0].HighByte << shift) & 0x80) >> 6;
+	}
+
+	uint8_t bgColor = (((_lowBitShift << _xScroll) & 0x8000) >> 15) | (((_highBitShift << _xScroll) & 0x8000) >> 14);
+	if(spriteColor != 0 && bgColor != 0) {
+		_statusFlags.Sprite0Hit = true;
+		_emu->AddDebugEvent<CpuType::Nes>(DebugEventType::SpriteZeroHit);
+	}
+}
+
 template<class T> void NesPpu<T>::ProcessScanlineImpl()
 {
 	//Only called for cycle 1+
@@ -868,7 +913,11 @@ template<class T> void NesPpu<T>::ProcessScanlineImpl()
 		}
 
 		if(_scanline >= 0) {
-			((T*)this)->DrawPixel();
+			if(_skipRender) {
+				ProcessSprite0Hit();
+			} else {
+				((T*)this)->DrawPixel();
+			}
 			ShiftTileRegisters();
 
 			//"Secondary OAM clear and sprite evaluation do not occur on the pre-render line"
@@ -1119,6 +1168,7 @@ template<class T> void NesPpu<T>::SendFrame()
 
 	RenderedFrame frame(_currentOutputBuffer, NesConstants::ScreenWidth, NesConstants::ScreenHeight, 1.0, _frameCount, _console->GetControlManager()->GetPortStates(), videoPhase);
 	frame.Data = frameData; //HD packs
+	frame.RenderingSkipped = _skipRender;
 
 	if(_console->GetVsMainConsole() || _console->GetVsSubConsole()) {
 		SendFrameVsDualSystem();
@@ -1140,6 +1190,7 @@ template<class T> void NesPpu<T>::SendFrameVsDualSystem()
 	bool forRewind = _emu->GetRewindManager()->IsRewinding();
 
 	RenderedFrame frame(_currentOutputBuffer, NesConstants::ScreenWidth, NesConstants::ScreenHeight, 1.0, _frameCount, _console->GetControlManager()->GetPortStates());
+	frame.RenderingSkipped = _skipRender;
 
 	if(cfg.VsDualVideoOutput == VsDualOutputOption::MainSystemOnly && _console->IsVsMainConsole()) {
 		_emu->GetVideoDecoder()->UpdateFrame(frame, forRewind, forRewind);
@@ -1162,6 +1213,7 @@ template<class T> void NesPpu<T>::SendFrameVsDualSystem()
 			}
 
 			RenderedFrame mergedFrame(mergedBuffer, NesConstants::ScreenWidth*2, NesConstants::ScreenHeight, 1.0, _frameCount, _console->GetControlManager()->GetPortStates());
+			mergedFrame.RenderingSkipped = _skipRender;
 			_emu->GetVideoDecoder()->UpdateFrame(mergedFrame, true, forRewind);
 			delete[] mergedBuffer;
 		}
@@ -1303,6 +1355,10 @@ template<class T> void NesPpu<T>::ProcessScanlineFirstCycle()
 
 		_emu->ProcessEvent(EventType::StartFrame);
 
+		//Pixels aren't drawn for run-ahead frames or when rendering is skipped (timing-related flags are still updated)
+		//Light guns read the frame's pixels, so they are always drawn when one is connected
+		_skipRender = (_emu->IsRunAheadFrame() || _emu->IsRenderingSkipped()) && !HasLightGun();
+
 		UpdateMinimumDrawCycles();
 	}
 
@@ -75,6 +75,8 @@ protected:
 	void ProcessOamCorruption();
 
 	__forceinline uint8_t GetPixelColor();
+	__forceinline void ProcessSprite0Hit();
+	bool HasLightGun();
 
 	void SendFrame();
 
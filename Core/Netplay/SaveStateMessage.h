@@ -29,6 +29,7 @@ public:
 		{
 			auto lock = emu->AcquireLock();
 			_activeCheats = emu->GetCheatManager()->GetCheats();
+			//Deflate is used so clients running older versions (which can't decode the fast codec) can still load the state
 			emu->Serialize(state, true);
 		}
 
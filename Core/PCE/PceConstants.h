@@ -18,6 +18,9 @@ public:
 	static constexpr uint32_t InternalOutputWidth = (256 + PceConstants::RowOverscanSize * 2) * PceConstants::InternalResMultipler;
 	static constexpr uint32_t InternalOutputHeight = PceConstants::ScreenHeight * PceConstants::InternalResMultipler;
 
+	//The output buffer has an extra line, used to store the clock divider values for each row
+	static constexpr uint32_t OutputBufferSize = PceConstants::MaxScreenWidth * (PceConstants::ScreenHeight + 1);
+
 	static constexpr uint32_t GetLeftOverscan(uint8_t vceClockDivider)
 	{
 		switch(vceClockDivider) {
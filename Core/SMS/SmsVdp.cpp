@@ -356,9 +356,17 @@ uint8_t SmsVdp::ReverseBitOrder(uint8_t val)
 
 void SmsVdp::DrawPixel()
 {
-	_currentOutputBuffer[_state.Scanline * 256 + GetVisiblePixelIndex()] = GetPixelColor();
-	if(_needCramDot) {
-		_currentOutputBuffer[_state.Scanline * 256 + GetVisiblePixelIndex()] = _cramDotColor;
+	if(_skipRender) {
+		//The frame isn't drawn, but the sprite shifters and sprite collision flag must still be updated
+		if(_state.Cycle >= _minDrawCycle) {
+			uint8_t spritePixelColor;
+			ProcessSpritePixel(spritePixelColor);
+		}
+	} else {
+		_currentOutputBuffer[_state.Scanline * 256 + GetVisiblePixelIndex()] = GetPixelColor();
+		if(_needCramDot) {
+			_currentOutputBuffer[_state.Scanline * 256 + GetVisiblePixelIndex()] = _cramDotColor;
+		}
 	}
 	_bgShifters[0] <<= 1;
 	_bgShifters[1] <<= 1;
@@ -427,6 +435,7 @@ void SmsVdp::ProcessScanlineEvents()
 				uint32_t width = _console->GetModel() == SmsModel::Sms ? 256 : 160;
 				uint32_t height = _console->GetModel() == SmsModel::Sms ? 240 : 144;
 				RenderedFrame frame(_currentOutputBuffer, width, height, 1.0, _state.FrameCount, _console->GetControlManager()->GetPortStates());
+				frame.RenderingSkipped = _skipRender;
 				bool rewinding = _emu->GetRewindManager()->IsRewinding();
 				_emu->GetVideoDecoder()->UpdateFrame(frame, rewinding, rewinding);
 
@@ -439,6 +448,12 @@ void SmsVdp::ProcessScanlineEvents()
 				_state.Scanline = 0;
 				_state.VerticalScrollLatch = _state.VerticalScroll;
 				_emu->ProcessEvent(EventType::StartFrame, CpuType::Sms);
+
+				//Pixels aren't drawn for run-ahead frames or when rendering is skipped (unless the light phaser needs them)
+				_skipRender = (
+					(_emu->IsRunAheadFrame() || _emu->IsRenderingSkipped()) &&
+					!_console->GetControlManager()->HasControlDevice(ControllerType::SmsLightPhaser)
+				);
 			}
 
 			_bgShifters[0] = 0;
@@ -609,14 +624,10 @@ bool SmsVdp::IsZoomedSpriteAllowed(int spriteIndex)
 	return _state.EnableDoubleSpriteSize && (spriteIndex < 4 || _console->GetRevision() != SmsRevision::Sms1);
 }
 
-uint16_t SmsVdp::GetPixelColor()
+bool SmsVdp::ProcessSpritePixel(uint8_t& spritePixelColor)
 {
-	if(_state.Cycle < _minDrawCycle) {
-		return _internalPaletteRam[0x10 | _state.BackgroundColorIndex];
-	}
-
 	bool spriteDrawn = false;
-	uint8_t spritePixelColor = 0;
+	spritePixelColor = 0;
 	uint16_t xPos = GetVisiblePixelIndex();
 	for(int i = 0; i < _spriteCount; i++) {
 		if(xPos >= _spriteShifters[i].SpriteX && xPos < _spriteShifters[i].SpriteX + (8 << (uint8_t)IsZoomedSpriteAllowed(i))) {
@@ -666,6 +677,18 @@ uint16_t SmsVdp::GetPixelColor()
 		}
 	}
 
+	return spriteDrawn;
+}
+
+uint16_t SmsVdp::GetPixelColor()
+{
+	if(_state.Cycle < _minDrawCycle) {
+		return _internalPaletteRam[0x10 | _state.BackgroundColorIndex];
+	}
+
+	uint8_t spritePixelColor;
+	bool spriteDrawn = ProcessSpritePixel(spritePixelColor);
+
 	uint8_t color = (
 		((_bgShifters[0] >> 23) & 0x01) |
 		((_bgShifters[1] >> 22) & 0x02) |
@@ -77,6 +77,8 @@ private:
 	bool _needCramDot = false;
 	uint16_t _cramDotColor = 0;
 
+	bool _skipRender = false;
+
 	//Used by SG-1000 modes
 	uint16_t _bgTileIndex = 0;
 	uint8_t _bgPatternData = 0;
@@ -97,6 +99,7 @@ private:
 	__forceinline void DrawPixel();
 	__forceinline void ProcessScanlineEvents();
 	__forceinline uint16_t GetPixelColor();
+	__forceinline bool ProcessSpritePixel(uint8_t& spritePixelColor);
 
 	void WriteRegister(uint8_t reg, uint8_t value);
 	void WriteSmsPalette(uint8_t addr, uint8_t value);
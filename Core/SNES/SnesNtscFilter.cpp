@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "SNES/SnesNtscFilter.h"
+#include "Utilities/RowBandThreadPool.h"
 #include "Shared/EmuSettings.h"
 #include "Shared/SettingTypes.h"
 #include "Shared/Emulator.h"
@@ -52,15 +53,26 @@ void SnesNtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 	uint32_t xOffset = overscan.Left;
 	uint32_t yOffset = overscan.Top/2 * baseWidth;
 
+	//Each row is filtered independently (the burst phase changes on every row), so the frame can be split in bands
+	uint32_t inWidth = _baseFrameInfo.Width;
+	int firstBurstPhase = IsOddFrame() ? 0 : 1;
+	RowBandThreadPool::GetInstance().Run(_baseFrameInfo.Height, 16, [=](uint32_t startRow, uint32_t endRow) {
+		int burstPhase = (firstBurstPhase + startRow) % snes_ntsc_burst_count;
+		uint16_t* input = ppuOutputBuffer + startRow * inWidth;
+		uint32_t* output = _ntscBuffer + startRow * baseWidth;
+		if(useHighResOutput) {
+			snes_ntsc_blit_hires(&_ntscData, input, inWidth, burstPhase, inWidth, endRow - startRow, output, baseWidth * 4);
+		} else {
+			snes_ntsc_blit(&_ntscData, input, inWidth, burstPhase, inWidth, endRow - startRow, output, baseWidth * 4);
+		}
+	});
+
 	if(useHighResOutput) {
-		snes_ntsc_blit_hires(&_ntscData, ppuOutputBuffer, _baseFrameInfo.Width, IsOddFrame() ? 0 : 1, _baseFrameInfo.Width, _baseFrameInfo.Height, _ntscBuffer, baseWidth * 4);
 		
 		for(uint32_t i = 0; i < frameInfo.Height; i++) {
 			memcpy(GetOutputBuffer() + i * frameInfo.Width, _ntscBuffer + yOffset*2 + xOffset + i * baseWidth, frameInfo.Width * sizeof(uint32_t));
 		}
 	} else {
-		snes_ntsc_blit(&_ntscData, ppuOutputBuffer, _baseFrameInfo.Width, IsOddFrame() ? 0 : 1, _baseFrameInfo.Width, _baseFrameInfo.Height, _ntscBuffer, baseWidth * 4);
-
 		for(uint32_t i = 0; i < frameInfo.Height; i += 2) {
 			memcpy(GetOutputBuffer() + i * frameInfo.Width, _ntscBuffer + yOffset + xOffset + i / 2 * baseWidth, frameInfo.Width * sizeof(uint32_t));
 			memcpy(GetOutputBuffer() + (i + 1) * frameInfo.Width, _ntscBuffer + yOffset + xOffset + i / 2 * baseWidth, frameInfo.Width * sizeof(uint32_t));
@@ -501,7 +501,9 @@ bool SnesPpu::ProcessEndOfScanline(uint16_t& hClock)
 				_frameSkipTimer.GetElapsedMS() < 10
 			);
 			
-			if(_emu->IsRunAheadFrame()) {
+			//Frames skipped by the skip rendering mode aren't sent to the video decoder (unlike frames skipped by frame skipping)
+			_renderingSkipped = _emu->IsRunAheadFrame() || _emu->IsRenderingSkipped();
+			if(_renderingSkipped) {
 				_skipRender = true;
 			}
 
@@ -1511,6 +1513,7 @@ void SnesPpu::SendFrame()
 	_needFullFrame = false;
 
 	RenderedFrame frame(_currentBuffer, width, height, _useHighResOutput ? 0.5 : 1.0, _frameCount, _console->GetControlManager()->GetPortStates());
+	frame.RenderingSkipped = _renderingSkipped;
 	_emu->GetVideoDecoder()->UpdateFrame(frame, isRewinding, isRewinding);
 
 	if(!_skipRender) {
@@ -106,6 +106,7 @@ private:
 
 	Timer _frameSkipTimer;
 	bool _skipRender = false;
+	bool _renderingSkipped = false;
 	uint8_t _configVisibleLayers = 0xFF;
 
 	uint8_t _spritePriority[256] = {};
@@ -8,6 +8,7 @@
 #include "Shared/Video/VideoRenderer.h"
 #include "Shared/Audio/WaveRecorder.h"
 #include "Shared/Interfaces/IAudioProvider.h"
+#include "Shared/PerfCounters.h"
 #include "Utilities/Audio/Equalizer.h"
 #include "Utilities/Audio/ReverbFilter.h"
 #include "Utilities/Audio/CrossFeedFilter.h"
@@ -20,6 +21,7 @@ SoundMixer::SoundMixer(Emulator* emu)
 	_sampleBuffer = new int16_t[0x10000];
 	_reverbFilter.reset(new ReverbFilter());
 	_crossFeedFilter.reset(new CrossFeedFilter());
+	_sinkMode = AudioSinkMode::Default;
 }
 
 SoundMixer::~SoundMixer()
@@ -69,10 +71,27 @@ void SoundMixer::PlayAudioBuffer(int16_t* samples, uint32_t sampleCount, uint32_
 		return;
 	}
 
+	PerfTimer timer(_emu->GetPerfCounters(), PerfCounterType::PlayAudioBuffer);
+	AudioSinkMode sinkMode = _sinkMode;
+	bool isRecording = _waveRecorder || _emu->GetVideoRenderer()->IsRecording();
+	if(sinkMode != AudioSinkMode::Default) {
+		_leftSample = samples[0];
+		_rightSample = samples[1];
+		if(sinkMode == AudioSinkMode::Capture && !_emu->IsRunAheadFrame()) {
+			CaptureSamples(samples, sampleCount, sourceRate);
+		}
+
+		RewindManager* rewindManager = _emu->GetRewindManager();
+		if(!isRecording && !(rewindManager && rewindManager->IsRewinding())) {
+			//Nobody listens to the audio output, skip the resampler and the effects
+			return;
+		}
+		//The wave/video recorders and the rewind audio history still need the processed audio (it is not sent to the audio device)
+	}
+
 	EmuSettings* settings = _emu->GetSettings();
 	AudioPlayerHud* audioPlayer = _emu->GetAudioPlayerHud();
 	AudioConfig cfg = settings->GetAudioConfig();
-	bool isRecording = _waveRecorder || _emu->GetVideoRenderer()->IsRecording();
 
 	uint32_t masterVolume = audioPlayer ? audioPlayer->GetVolume() : cfg.MasterVolume;
 	if(!isRecording) {
@@ -140,7 +159,7 @@ void SoundMixer::PlayAudioBuffer(int16_t* samples, uint32_t sampleCount, uint32_
 
 		//Only send the audio to the device if the emulation is running
 		//(this is to prevent playing an audio blip when loading a save state)
-		if(!_emu->IsPaused() && _audioDevice) {
+		if(sinkMode == AudioSinkMode::Default && !_emu->IsPaused() && _audioDevice) {
 			if(cfg.EnableAudio) {
 				_audioDevice->PlayBuffer(out, count, cfg.SampleRate, true);
 				_audioDevice->ProcessEndOfFrame();
@@ -151,6 +170,47 @@ void SoundMixer::PlayAudioBuffer(int16_t* samples, uint32_t sampleCount, uint32_
 	}
 }
 
+void SoundMixer::SetSinkMode(AudioSinkMode mode)
+{
+	if(mode != AudioSinkMode::Default && _audioDevice) {
+		_audioDevice->Stop();
+	}
+
+	{
+		auto lock = _captureLock.AcquireSafe();
+		_capturedSamples.clear();
+	}
+	_sinkMode = mode;
+}
+
+void SoundMixer::CaptureSamples(int16_t* samples, uint32_t sampleCount, uint32_t sourceRate)
+{
+	auto lock = _captureLock.AcquireSafe();
+	if(_captureRate != sourceRate) {
+		_capturedSamples.clear();
+		_captureRate = sourceRate;
+	}
+
+	//Keep at most ~2 seconds of audio when the samples aren't read
+	size_t maxSize = (size_t)sourceRate * 2 * 2;
+	if(_capturedSamples.size() + sampleCount * 2 > maxSize) {
+		size_t overflow = std::min(_capturedSamples.size(), _capturedSamples.size() + sampleCount * 2 - maxSize);
+		_capturedSamples.erase(_capturedSamples.begin(), _capturedSamples.begin() + overflow);
+	}
+	_capturedSamples.insert(_capturedSamples.end(), samples, samples + sampleCount * 2);
+}
+
+uint32_t SoundMixer::ReadCapturedSamples(vector<int16_t>& out, size_t maxCount)
+{
+	//Removes up to maxCount values (rounded down to whole stereo samples) from the capture buffer,
+	//the remaining samples are kept for the next call
+	auto lock = _captureLock.AcquireSafe();
+	size_t count = std::min(maxCount, _capturedSamples.size()) & ~(size_t)1;
+	out.assign(_capturedSamples.begin(), _capturedSamples.begin() + count);
+	_capturedSamples.erase(_capturedSamples.begin(), _capturedSamples.begin() + count);
+	return _captureRate;
+}
+
 void SoundMixer::ProcessEqualizer(int16_t* samples, uint32_t sampleCount, uint32_t targetRate)
 {
 	AudioConfig cfg = _emu->GetSettings()->GetAudioConfig();
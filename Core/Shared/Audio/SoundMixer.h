@@ -2,6 +2,7 @@
 #include "pch.h"
 #include "Core/Shared/Interfaces/IAudioDevice.h"
 #include "Utilities/safe_ptr.h"
+#include "Utilities/SimpleLock.h"
 
 class Emulator;
 class Equalizer;
@@ -11,6 +12,13 @@ class IAudioProvider;
 class CrossFeedFilter;
 class ReverbFilter;
 
+enum class AudioSinkMode
+{
+	Default, //Resample the samples, apply the effects and send them to the audio device
+	Drop, //Drop the samples produced by the console (the APU still runs normally)
+	Capture //Keep the console's samples (stereo, at the source rate) for ReadCapturedSamples(), skipping the resampler and effects
+};
+
 class SoundMixer 
 {
 private:
@@ -28,6 +36,13 @@ private:
 	unique_ptr<CrossFeedFilter> _crossFeedFilter;
 	unique_ptr<ReverbFilter> _reverbFilter;
 
+	atomic<AudioSinkMode> _sinkMode;
+	SimpleLock _captureLock;
+	deque<int16_t> _capturedSamples;
+	uint32_t _captureRate = 0;
+
+	void CaptureSamples(int16_t* samples, uint32_t sampleCount, uint32_t sourceRate);
+
 	void ProcessEqualizer(int16_t *samples, uint32_t sampleCount, uint32_t targetRate);
 
 public:
@@ -49,4 +64,8 @@ public:
 	void StopRecording();
 	bool IsRecording();
 	void GetLastSamples(int16_t &left, int16_t &right);
+
+	void SetSinkMode(AudioSinkMode mode);
+	AudioSinkMode GetSinkMode() { return _sinkMode; }
+	uint32_t ReadCapturedSamples(vector<int16_t>& out, size_t maxCount = SIZE_MAX);
 };
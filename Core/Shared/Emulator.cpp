@@ -24,6 +24,8 @@
 #include "Shared/Movies/MovieManager.h"
 #include "Shared/TimingInfo.h"
 #include "Shared/HistoryViewer.h"
+#include "Shared/StepInputProvider.h"
+#include "Shared/PerfCounters.h"
 #include "Netplay/GameServer.h"
 #include "Netplay/GameClient.h"
 #include "Shared/Interfaces/IConsole.h"
@@ -50,6 +52,7 @@
 #include "Shared/EventType.h"
 
 Emulator::Emulator() :
+	_perfCounters(new PerfCounters()),
 	_settings(new EmuSettings(this)),
 	_debugHud(new DebugHud()),
 	_scriptHud(new DebugHud()),
@@ -64,7 +67,8 @@ Emulator::Emulator() :
 	_historyViewer(new HistoryViewer(this)),
 	_gameServer(new GameServer(this)),
 	_gameClient(new GameClient(this)),
-	_rewindManager(new RewindManager(this))
+	_rewindManager(new RewindManager(this)),
+	_stepInputProvider(new StepInputProvider())
 {
 	_paused = false;
 	_pauseOnNextFrame = false;
@@ -72,6 +76,10 @@ Emulator::Emulator() :
 	_isRunAheadFrame = false;
 	_lockCounter = 0;
 	_threadPaused = false;
+	_stepMode = false;
+	_stepping = false;
+	_scriptHostMode = false;
+	_skipRendering = false;
 
 	_debugRequestCount = 0;
 	_blockDebuggerRequestCount = 0;
@@ -83,8 +91,12 @@ Emulator::~Emulator()
 {
 }
 
-void Emulator::Initialize(bool enableShortcuts)
+void Emulator::Initialize(bool enableShortcuts, bool headless)
 {
+	_headless = headless;
+	if(headless) {
+		_soundMixer->SetSinkMode(AudioSinkMode::Drop);
+	}
 	_systemActionManager.reset(new SystemActionManager(this));
 	if(enableShortcuts) {
 		_shortcutKeyHandler.reset(new ShortcutKeyHandler(this));
@@ -137,7 +149,7 @@ void Emulator::Run()
 		if(useRunAhead) {
 			RunFrameWithRunAhead();
 		} else {
-			_console->RunFrame();
+			RunConsoleFrame();
 			_rewindManager->ProcessEndOfFrame();
 			_historyViewer->ProcessEndOfFrame();
 			ProcessSystemActions();
@@ -168,6 +180,86 @@ void Emulator::Run()
 	PlatformUtilities::RestoreTimerResolution();
 }
 
+void Emulator::SetStepMode(bool enabled)
+{
+	if(_stepMode == enabled) {
+		return;
+	}
+
+	if(enabled) {
+		//Stop the emulation thread without unloading the game, frames are then only
+		//emulated when Step() is called, on the calling thread
+		if(_emuThread) {
+			SuspendDebugger(false);
+			_stopFlag = true;
+			_emuThread->join();
+			_emuThread.reset();
+			_stopFlag = false;
+			SuspendDebugger(true);
+		}
+		_stepMode = true;
+	} else {
+		//Wait for any Step() call in progress to end before restarting the emulation thread
+		_runLock.WaitForRelease();
+		_stepMode = false;
+		if(_console && !_emuThread) {
+			_emuThread.reset(new thread(&Emulator::Run, this));
+		}
+	}
+}
+
+void Emulator::SetScriptHostMode(bool enabled)
+{
+	//In script host mode, the debugger only runs the scripts' event and memory callbacks - the cpu debuggers,
+	//breakpoints, access counters, event viewer, etc. are skipped to run the scripts as fast as possible.
+	//The setting is kept by the emulator so debuggers created later on (e.g after loading a game) also use it.
+	_scriptHostMode = enabled;
+
+	auto lock = _debuggerLock.AcquireSafe();
+	shared_ptr<Debugger> debugger = _debugger.lock();
+	if(debugger) {
+		debugger->SetScriptHostMode(enabled);
+	}
+}
+
+bool Emulator::Step(uint32_t frameCount, const vector<uint32_t>& portButtons)
+{
+	if(!_stepMode || !_console) {
+		return false;
+	}
+
+	//Runs the frames inline on the calling thread: no frame limiter, no pause handling
+	//and no handoff with the emulation thread (which is not running in step mode)
+	auto lock = _runLock.AcquireSafe();
+	if(!_console || _stopFlag) {
+		return false;
+	}
+
+	thread::id prevThreadId = _emulationThreadId;
+	_emulationThreadId = std::this_thread::get_id();
+	_stepping = true;
+
+	_stepInputProvider->SetButtons(portButtons);
+	if(!portButtons.empty()) {
+		_console->GetControlManager()->RegisterInputProvider(_stepInputProvider.get());
+	}
+
+	for(uint32_t i = 0; i < frameCount && !_stopFlag; i++) {
+		RunConsoleFrame();
+		_rewindManager->ProcessEndOfFrame();
+		_historyViewer->ProcessEndOfFrame();
+		ProcessSystemActions();
+	}
+
+	if(!portButtons.empty()) {
+		_console->GetControlManager()->UnregisterInputProvider(_stepInputProvider.get());
+	}
+
+	_stepping = false;
+	_emulationThreadId = prevThreadId;
+	return true;
+}
+
 void Emulator::ProcessAutoSaveState()
 {
 	if(_autoSaveStateFrameCounter > 0) {
@@ -201,25 +293,38 @@ bool Emulator::ProcessSystemActions()
 	return false;
 }
 
+void Emulator::RunConsoleFrame()
+{
+	PerfTimer timer(_perfCounters.get(), PerfCounterType::RunFrame);
+	_console->RunFrame();
+}
+
 void Emulator::RunFrameWithRunAhead()
 {
-	stringstream runAheadState;
 	uint32_t frameCount = _settings->GetEmulationConfig().RunAheadFrames;
 
 	//Run a single frame and save the state (no audio/video)
+	//The raw format is used: each value is copied as-is, without building keys or a stream
 	_isRunAheadFrame = true;
-	_console->RunFrame();
-	Serialize(runAheadState, false, 0);
+	RunConsoleFrame();
+
+	//The same serializer is reused every frame to avoid reallocating its buffer
+	if(_runAheadState) {
+		_runAheadState->ResetRaw(true);
+	} else {
+		_runAheadState.reset(new Serializer(SaveStateManager::FileFormatVersion, true, SerializeFormat::Raw));
+	}
+	Serialize(*_runAheadState);
 
 	while(frameCount > 1) {
 		//Run extra frames if the requested run ahead frame count is higher than 1
 		frameCount--;
-		_console->RunFrame();
+		RunConsoleFrame();
 	}
 	_isRunAheadFrame = false;
 
 	//Run one frame normally (with audio/video output)
-	_console->RunFrame();
+	RunConsoleFrame();
 	_rewindManager->ProcessEndOfFrame();
 	_historyViewer->ProcessEndOfFrame();
 
@@ -227,7 +332,9 @@ void Emulator::RunFrameWithRunAhead()
 	if(!wasReset) {
 		//Load the state we saved earlier
 		_isRunAheadFrame = true;
-		Deserialize(runAheadState, SaveStateManager::FileFormatVersion, false);
+		if(_runAheadState->ResetRaw(false)) {
+			Deserialize(*_runAheadState);
+		}
 		_isRunAheadFrame = false;
 	}
 }
@@ -250,18 +357,20 @@ void Emulator::OnBeforeSendFrame()
 void Emulator::ProcessEndOfFrame()
 {
 	if(!_isRunAheadFrame) {
-		_frameLimiter->ProcessFrame();
-		while(_frameLimiter->WaitForNextFrame()) {
-			if(_stopFlag || _frameDelay != GetFrameDelay() || _paused || _pauseOnNextFrame || _lockCounter > 0) {
-				//Need to process another event, stop sleeping
-				break;
+		if(!_stepMode) {
+			_frameLimiter->ProcessFrame();
+			while(_frameLimiter->WaitForNextFrame()) {
+				if(_stopFlag || _frameDelay != GetFrameDelay() || _paused || _pauseOnNextFrame || _lockCounter > 0) {
+					//Need to process another event, stop sleeping
+					break;
+				}
 			}
-		}
 
-		double newFrameDelay = GetFrameDelay();
-		if(newFrameDelay != _frameDelay) {
-			_frameDelay = newFrameDelay;
-			_frameLimiter->SetDelay(_frameDelay);
+			double newFrameDelay = GetFrameDelay();
+			if(newFrameDelay != _frameDelay) {
+				_frameDelay = newFrameDelay;
+				_frameLimiter->SetDelay(_frameDelay);
+			}
 		}
 
 		_console->GetControlManager()->ProcessEndOfFrame();
@@ -282,6 +391,9 @@ void Emulator::Stop(bool sendNotification, bool preventRecentGameSave, bool save
 	if(_emuThread) {
 		_emuThread->join();
 		_emuThread.release();
+	} else if(_stepMode) {
+		//Wait for the current Step() call to end
+		_runLock.WaitForRelease();
 	}
 
 	if(!preventRecentGameSave && _console && !_settings->GetPreferences().DisableGameSelectionScreen && !_audioPlayerHud) {
@@ -520,7 +632,9 @@ bool Emulator::InternalLoadRom(VirtualFile romFile, VirtualFile patchFile, bool
 
 	if(stopRom) {
 		_stopFlag = false;
-		_emuThread.reset(new thread(&Emulator::Run, this));
+		if(!_stepMode) {
+			_emuThread.reset(new thread(&Emulator::Run, this));
+		}
 	}
 
 	return true;
@@ -542,6 +656,7 @@ void Emulator::InitConsole(unique_ptr<IConsole>& newConsole, ConsoleMemoryInfo o
 
 	_console.reset(newConsole);
 	_consoleType = _console->GetConsoleType();
+	_rawStateSchemaHashValid = false;
 	_notificationManager->RegisterNotificationListener(_console.lock());
 }
 
@@ -851,7 +966,7 @@ void Emulator::Unlock()
 
 bool Emulator::IsThreadPaused()
 {
-	return !_emuThread || _threadPaused;
+	return (!_emuThread && !_stepping) || _threadPaused;
 }
 
 void Emulator::SuspendDebugger(bool release)
@@ -886,18 +1001,20 @@ void Emulator::WaitForLock()
 	}
 }
 
-void Emulator::Serialize(ostream& out, bool includeSettings, int compressionLevel)
+void Emulator::Serialize(ostream& out, bool includeSettings, int compressionLevel, CompressionType compressionType)
 {
+	PerfTimer timer(_perfCounters.get(), PerfCounterType::Serialize);
 	Serializer s(SaveStateManager::FileFormatVersion, true);
 	if(includeSettings) {
 		SV(_settings);
 	}
 	s.Stream(_console, "");
-	s.SaveTo(out, compressionLevel);
+	s.SaveTo(out, compressionLevel, compressionType);
 }
 
 bool Emulator::Deserialize(istream& in, uint32_t fileFormatVersion, bool includeSettings, optional<ConsoleType> srcConsoleType)
 {
+	PerfTimer timer(_perfCounters.get(), PerfCounterType::Deserialize);
 	Serializer s(fileFormatVersion, false);
 	if(!s.LoadFrom(in)) {
 		return false;
@@ -935,6 +1052,48 @@ bool Emulator::Deserialize(istream& in, uint32_t fileFormatVersion, bool include
 	return true;
 }
 
+void Emulator::Serialize(Serializer& s)
+{
+	PerfTimer timer(_perfCounters.get(), PerfCounterType::Serialize);
+	s.Stream(_console, "");
+	if(s.GetFormat() == SerializeFormat::Raw) {
+		_rawStateSchemaHash = s.GetSchemaHash();
+		_rawStateSchemaHashValid = true;
+	}
+}
+
+bool Emulator::Deserialize(Serializer& s)
+{
+	PerfTimer timer(_perfCounters.get(), PerfCounterType::Deserialize);
+	if(s.GetFormat() == SerializeFormat::Raw) {
+		if(!_rawStateSchemaHashValid) {
+			//Save a state to calculate the console's current layout
+			//(not done via Serialize() to avoid counting this as a separate Serialize call in the perf counters)
+			Serializer layout(SaveStateManager::FileFormatVersion, true, SerializeFormat::Raw);
+			layout.Stream(_console, "");
+			_rawStateSchemaHash = layout.GetSchemaHash();
+			_rawStateSchemaHashValid = true;
+		}
+
+		if(s.GetSchemaHash() != _rawStateSchemaHash) {
+			//Raw states can only be loaded if their layout matches the console's exactly
+			MessageManager::DisplayMessage("SaveStates", "SaveStateWrongSystem");
+			return false;
+		}
+	}
+
+	//The serializer's data can be streamed into the console multiple times (used by in-memory snapshots)
+	s.ResetPosition();
+	s.Stream(_console, "");
+
+	if(s.GetFormat() == SerializeFormat::Raw && !s.IsRawLoadComplete()) {
+		return false;
+	}
+
+	_notificationManager->SendNotification(ConsoleNotificationType::StateLoaded);
+	return true;
+}
+
 BaseVideoFilter* Emulator::GetVideoFilter(bool getDefaultFilter)
 {
 	shared_ptr<IConsole> console = GetConsole();
@@ -1023,6 +1182,11 @@ void Emulator::ResetDebugger(bool startDebugger)
 
 void Emulator::InitDebugger()
 {
+	if(!DebuggerEnabled) {
+		MessageManager::Log("[Debugger] This build was compiled without debugger support (MESEN_NO_DEBUGGER).");
+		return;
+	}
+
 	if(!_debugger) {
 		//Lock to make sure we don't try to start debuggers in 2 separate threads at once
 		auto lock = _debuggerLock.AcquireSafe();
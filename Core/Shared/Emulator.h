@@ -10,6 +10,7 @@
 #include "Utilities/safe_ptr.h"
 #include "Utilities/SimpleLock.h"
 #include "Utilities/VirtualFile.h"
+#include "Utilities/CompressionHelper.h"
 
 class Debugger;
 class DebugHud;
@@ -34,6 +35,9 @@ class SystemActionManager;
 class AudioPlayerHud;
 class GameServer;
 class GameClient;
+class StepInputProvider;
+class Serializer;
+class PerfCounters;
 
 class IInputRecorder;
 class IInputProvider;
@@ -69,6 +73,7 @@ private:
 	safe_ptr<Debugger> _debugger;
 	shared_ptr<SystemActionManager> _systemActionManager;
 
+	const unique_ptr<PerfCounters> _perfCounters;
 	const unique_ptr<EmuSettings> _settings;
 	const unique_ptr<DebugHud> _debugHud;
 	const unique_ptr<DebugHud> _scriptHud;
@@ -104,6 +109,18 @@ private:
 	atomic<bool> _isRunAheadFrame;
 	bool _frameRunning = false;
 
+	atomic<bool> _stepMode;
+	atomic<bool> _stepping;
+	atomic<bool> _scriptHostMode;
+	atomic<bool> _skipRendering;
+	bool _headless = false;
+	unique_ptr<StepInputProvider> _stepInputProvider;
+	unique_ptr<Serializer> _runAheadState;
+
+	//Layout hash of the current console's raw format states
+	uint64_t _rawStateSchemaHash = 0;
+	bool _rawStateSchemaHashValid = false;
+
 	RomInfo _rom;
 	ConsoleType _consoleType = {};
 
@@ -123,6 +140,7 @@ private:
 	void ProcessAutoSaveState();
 	bool ProcessSystemActions();
 	void RunFrameWithRunAhead();
+	void RunConsoleFrame();
 
 	void BlockDebuggerRequests();
 	void ResetDebugger(bool startDebugger = false);
@@ -140,10 +158,15 @@ public:
 	Emulator();
 	~Emulator();
 
-	void Initialize(bool enableShortcuts = true);
+	void Initialize(bool enableShortcuts = true, bool headless = false);
 	void Release();
 
 	void Run();
+	void SetStepMode(bool enabled);
+	bool IsStepMode() { return _stepMode; }
+	void SetScriptHostMode(bool enabled);
+	bool IsScriptHostMode() { return _scriptHostMode; }
+	bool Step(uint32_t frameCount, const vector<uint32_t>& portButtons = {});
 	void Stop(bool sendNotification, bool preventRecentGameSave = false, bool saveBattery = true);
 
 	void OnBeforeSendFrame();
@@ -179,10 +202,13 @@ public:
 
 	void SuspendDebugger(bool release);
 
-	void Serialize(ostream& out, bool includeSettings, int compressionLevel = 1);
+	void Serialize(ostream& out, bool includeSettings, int compressionLevel = 1, CompressionType compressionType = CompressionType::Deflate);
 	bool Deserialize(istream& in, uint32_t fileFormatVersion, bool includeSettings, optional<ConsoleType> consoleType = std::nullopt);
+	void Serialize(Serializer& s);
+	bool Deserialize(Serializer& s);
 
 	SoundMixer* GetSoundMixer() { return _soundMixer.get(); }
+	PerfCounters* GetPerfCounters() { return _perfCounters.get(); }
 	VideoRenderer* GetVideoRenderer() { return _videoRenderer.get(); }
 	VideoDecoder* GetVideoDecoder() { return _videoDecoder.get(); }
 	ShortcutKeyHandler* GetShortcutKeyHandler() { return _shortcutKeyHandler.get(); }
@@ -230,6 +256,13 @@ public:
 	bool IsRunning() { return _console != nullptr; }
 	bool IsRunAheadFrame() { return _isRunAheadFrame; }
 
+	//When set, the consoles skip drawing the frames' pixels (and the frames aren't sent to the video decoder)
+	void SetSkipRendering(bool skip) { _skipRendering = skip; }
+	bool IsRenderingSkipped() { return _skipRendering; }
+
+	//Headless instances have no video decoder/renderer threads - frames are only kept for synchronous consumers
+	bool IsHeadless() { return _headless; }
+
 	TimingInfo GetTimingInfo(CpuType cpuType);
 	uint32_t GetFrameCount();
 
@@ -242,24 +275,33 @@ public:
 	void UnregisterInputProvider(IInputProvider* provider);
 
 	double GetFps();
-	
+
+#ifdef MESEN_NO_DEBUGGER
+	//Builds made with MESEN_NO_DEBUGGER can't start the debugger, which lets the compiler remove
+	//all the debugger hooks below from the emulation cores (this variant is built as a separate
+	//library, see the makefile - hosts load the regular core when they need a debugger or scripts)
+	static constexpr bool DebuggerEnabled = false;
+#else
+	static constexpr bool DebuggerEnabled = true;
+#endif
+
 	template<CpuType type> __forceinline void ProcessInstruction()
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessInstruction<type>();
 		}
 	}
 
 	template<CpuType type, MemoryAccessFlags flags = MemoryAccessFlags::None, typename T> __forceinline void ProcessMemoryRead(uint32_t addr, T& value, MemoryOperationType opType)
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessMemoryRead<type, flags>(addr, value, opType);
 		}
 	}
 
 	template<CpuType type, MemoryAccessFlags flags = MemoryAccessFlags::None, typename T> __forceinline bool ProcessMemoryWrite(uint32_t addr, T& value, MemoryOperationType opType)
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			return _debugger->ProcessMemoryWrite<type, flags>(addr, value, opType);
 		}
 		return true;
@@ -267,56 +309,56 @@ public:
 
 	template<CpuType cpuType, MemoryType memType, MemoryOperationType opType> __forceinline void ProcessMemoryAccess(uint32_t addr, uint8_t value)
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessMemoryAccess<cpuType, memType, opType>(addr, value);
 		}
 	}
 
 	template<CpuType type> __forceinline void ProcessIdleCycle()
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessIdleCycle<type>();
 		}
 	}
 
 	template<CpuType type> __forceinline void ProcessHaltedCpu()
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessHaltedCpu<type>();
 		}
 	}
 
 	template<CpuType type, typename T> __forceinline void ProcessPpuRead(uint32_t addr, T& value, MemoryType memoryType, MemoryOperationType opType = MemoryOperationType::Read)
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessPpuRead<type>(addr, value, memoryType, opType);
 		}
 	}
 
 	template<CpuType type, typename T> __forceinline void ProcessPpuWrite(uint32_t addr, T& value, MemoryType memoryType)
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessPpuWrite<type>(addr, value, memoryType);
 		}
 	}
 
 	template<CpuType type> __forceinline void ProcessPpuCycle()
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessPpuCycle<type>();
 		}
 	}
 
 	template<CpuType type> void ProcessInterrupt(uint32_t originalPc, uint32_t currentPc, bool forNmi)
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->ProcessInterrupt<type>(originalPc, currentPc, forNmi);
 		}
 	}
 
 	__forceinline void DebugLog(string log)
 	{
-		if(_debugger) {
+		if(DebuggerEnabled && _debugger) {
 			_debugger->Log(log);
 		}
 	}
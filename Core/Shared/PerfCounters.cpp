@@ -0,0 +1,69 @@
+#include "pch.h"
+#include "Shared/PerfCounters.h"
+
+PerfCounters::PerfCounters()
+{
+	Reset();
+}
+
+void PerfCounters::AddSample(PerfCounterType type, uint64_t elapsedNs)
+{
+	Counter& counter = _counters[(int)type];
+	counter.Count.fetch_add(1, std::memory_order_relaxed);
+	counter.TotalNs.fetch_add(elapsedNs, std::memory_order_relaxed);
+
+	uint64_t min = counter.MinNs.load(std::memory_order_relaxed);
+	while(elapsedNs < min && !counter.MinNs.compare_exchange_weak(min, elapsedNs, std::memory_order_relaxed)) {}
+
+	uint64_t max = counter.MaxNs.load(std::memory_order_relaxed);
+	while(elapsedNs > max && !counter.MaxNs.compare_exchange_weak(max, elapsedNs, std::memory_order_relaxed)) {}
+
+	int bucket = 0;
+	while(bucket < PerfCounterStats::HistogramSize - 1 && (elapsedNs >> (bucket + 1)) != 0) {
+		bucket++;
+	}
+	counter.Histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::GetStats(PerfCounterStats stats[CounterTypeCount])
+{
+	//The counters are updated by several threads (emulation, video decoder, etc.), so a counter's values
+	//may be slightly out of sync with each other if a sample is added while they are being read.
+	for(int i = 0; i < CounterTypeCount; i++) {
+		Counter& counter = _counters[i];
+		stats[i].Count = counter.Count.load(std::memory_order_relaxed);
+		stats[i].TotalNs = counter.TotalNs.load(std::memory_order_relaxed);
+		stats[i].MinNs = stats[i].Count ? counter.MinNs.load(std::memory_order_relaxed) : 0;
+		stats[i].MaxNs = counter.MaxNs.load(std::memory_order_relaxed);
+		for(int j = 0; j < PerfCounterStats::HistogramSize; j++) {
+			stats[i].Histogram[j] = counter.Histogram[j].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void PerfCounters::Reset()
+{
+	for(int i = 0; i < CounterTypeCount; i++) {
+		Counter& counter = _counters[i];
+		counter.Count = 0;
+		counter.TotalNs = 0;
+		counter.MinNs = UINT64_MAX;
+		counter.MaxNs = 0;
+		for(int j = 0; j < PerfCounterStats::HistogramSize; j++) {
+			counter.Histogram[j] = 0;
+		}
+	}
+}
+
+const char* PerfCounters::GetCounterName(PerfCounterType type)
+{
+	switch(type) {
+		case PerfCounterType::RunFrame: return "runFrame";
+		case PerfCounterType::ScriptEvent: return "scriptEvent";
+		case PerfCounterType::Serialize: return "serialize";
+		case PerfCounterType::Deserialize: return "deserialize";
+		case PerfCounterType::DecodeFrame: return "decodeFrame";
+		case PerfCounterType::PlayAudioBuffer: return "playAudioBuffer";
+	}
+	return "";
+}
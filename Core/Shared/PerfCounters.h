@@ -0,0 +1,78 @@
+#pragma once
+#include "pch.h"
+#include <chrono>
+
+enum class PerfCounterType
+{
+	RunFrame,
+	ScriptEvent,
+	Serialize,
+	Deserialize,
+	DecodeFrame,
+	PlayAudioBuffer
+};
+
+struct PerfCounterStats
+{
+	static constexpr int HistogramSize = 32;
+
+	uint64_t Count;
+	uint64_t TotalNs;
+	uint64_t MinNs;
+	uint64_t MaxNs;
+
+	//Histogram[i] is the number of samples that took between 2^i and 2^(i+1)-1 ns (the last entry also contains longer samples)
+	uint64_t Histogram[HistogramSize];
+};
+
+//Host-side timing of the emulator's main steps (time spent on the host, not emulated cycles).
+//Each step's time includes the steps it calls (e.g RunFrame includes the script events and PlayAudioBuffer)
+class PerfCounters
+{
+public:
+	static constexpr int CounterTypeCount = (int)PerfCounterType::PlayAudioBuffer + 1;
+
+private:
+	struct Counter
+	{
+		atomic<uint64_t> Count;
+		atomic<uint64_t> TotalNs;
+		atomic<uint64_t> MinNs;
+		atomic<uint64_t> MaxNs;
+		atomic<uint64_t> Histogram[PerfCounterStats::HistogramSize];
+	};
+
+	Counter _counters[CounterTypeCount];
+
+public:
+	PerfCounters();
+
+	void AddSample(PerfCounterType type, uint64_t elapsedNs);
+	void GetStats(PerfCounterStats stats[CounterTypeCount]);
+	void Reset();
+
+	static const char* GetCounterName(PerfCounterType type);
+};
+
+//Adds the time spent in the current scope to a counter
+class PerfTimer
+{
+private:
+	PerfCounters* _counters;
+	PerfCounterType _type;
+	std::chrono::high_resolution_clock::time_point _start;
+
+public:
+	PerfTimer(PerfCounters* counters, PerfCounterType type)
+	{
+		_counters = counters;
+		_type = type;
+		_start = std::chrono::high_resolution_clock::now();
+	}
+
+	~PerfTimer()
+	{
+		auto elapsed = std::chrono::high_resolution_clock::now() - _start;
+		_counters->AddSample(_type, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+};
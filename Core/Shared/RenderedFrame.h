@@ -14,6 +14,14 @@ struct RenderedFrame
 	uint32_t VideoPhase = 0;
 	vector<ControllerData> InputData;
 
+	//Set when the frame's pixels weren't drawn (skip rendering mode) - latched by the PPU at the start of the frame
+	bool RenderingSkipped = false;
+
+	//Size of FrameBuffer, in 16-bit values (only needed when it contains more than Width * Height values)
+	uint32_t FrameBufferSize = 0;
+
+	uint32_t GetFrameBufferSize() const { return FrameBufferSize ? FrameBufferSize : Width * Height; }
+
 	RenderedFrame()
 	{}
 
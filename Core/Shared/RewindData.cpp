@@ -4,36 +4,82 @@
 #include "Shared/SaveStateManager.h"
 #include "Utilities/CompressionHelper.h"
 
-void RewindData::GetStateData(stringstream &stateData, deque<RewindData>& prevStates, int32_t position)
+//Uncompressed copy of the last key state used by this thread - delta states are saved/loaded
+//against the same key state for 30 frames in a row, so it only needs to be decompressed once
+struct RewindKeyStateCache
 {
-	vector<uint8_t> data;
-	CompressionHelper::Decompress(_saveStateData, data);
-
-	if(!IsFullState) {
-		position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
-		ProcessXorState(data, prevStates, position);
-	}
+	uint64_t Id = 0;
+	vector<uint8_t> Data;
+};
 
-	stateData.write((char*)data.data(), data.size());
-}
+static thread_local RewindKeyStateCache _keyStateCache;
+static atomic<uint64_t> _nextKeyStateId(1);
 
-template<typename T>
-void RewindData::ProcessXorState(T& data, deque<RewindData>& prevStates, int32_t position)
+const vector<uint8_t>* RewindData::GetKeyState(deque<RewindData>& prevStates, int32_t position)
 {
-	//Find last full state and XOR with it
-	while(position >= 0 && position < prevStates.size()) {
+	//Find last full state
+	while(position >= 0 && position < (int32_t)prevStates.size()) {
 		RewindData& prevState = prevStates[position];
 		if(prevState.IsFullState) {
-			//XOR with previous state to restore state data to its initial state
-			vector<uint8_t> prevStateData;
-			CompressionHelper::Decompress(prevState._saveStateData, prevStateData);
-			for(size_t i = 0, len = std::min(prevStateData.size(), data.size()); i < len; i++) {
-				data[i] ^= prevStateData[i];
+			if(_keyStateCache.Id != prevState._keyStateId) {
+				_keyStateCache.Id = 0;
+				if(!CompressionHelper::Decompress(prevState._saveStateData, _keyStateCache.Data)) {
+					return nullptr;
+				}
+				_keyStateCache.Id = prevState._keyStateId;
 			}
-			break;
+			return &_keyStateCache.Data;
 		}
 		position--;
 	}
+	return nullptr;
+}
+
+bool RewindData::GetUncompressedState(vector<uint8_t>& data, deque<RewindData>& prevStates, int32_t position)
+{
+	if(IsFullState) {
+		return CompressionHelper::Decompress(_saveStateData, data);
+	}
+
+	vector<uint8_t> delta;
+	if(!CompressionHelper::Decompress(_saveStateData, delta) || delta.size() < sizeof(uint32_t)) {
+		return false;
+	}
+
+	//Delta format: state size, followed by the index and content of each page that differs from the key state
+	uint32_t size;
+	memcpy(&size, delta.data(), sizeof(uint32_t));
+
+	position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
+	const vector<uint8_t>* keyState = GetKeyState(prevStates, position);
+	data.resize(size);
+	if(keyState) {
+		memcpy(data.data(), keyState->data(), std::min<size_t>(size, keyState->size()));
+	}
+
+	size_t offset = sizeof(uint32_t);
+	while(offset + sizeof(uint32_t) <= delta.size()) {
+		uint32_t page;
+		memcpy(&page, delta.data() + offset, sizeof(uint32_t));
+		offset += sizeof(uint32_t);
+
+		size_t start = (size_t)page * PageSize;
+		size_t len = std::min<size_t>(PageSize, size - start);
+		if(start >= size || offset + len > delta.size()) {
+			return false;
+		}
+		memcpy(data.data() + start, delta.data() + offset, len);
+		offset += len;
+	}
+	return true;
+}
+
+void RewindData::GetStateData(stringstream &stateData, deque<RewindData>& prevStates, int32_t position)
+{
+	vector<uint8_t> data;
+	if(GetUncompressedState(data, prevStates, position)) {
+		stateData.write((char*)data.data(), data.size());
+	}
 }
 
 void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t position)
@@ -43,11 +89,8 @@ void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t
 	}
 		
 	vector<uint8_t> data;
-	CompressionHelper::Decompress(_saveStateData, data);
-
-	if(!IsFullState) {
-		position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
-		ProcessXorState(data, prevStates, position);
+	if(!GetUncompressedState(data, prevStates, position)) {
+		return;
 	}
 
 	stringstream stream;
@@ -67,12 +110,32 @@ void RewindData::SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t
 	position = position > 0 ? position : (int32_t)prevStates.size();
 
 	if(position > 0 && (position % 30) != 0) {
-		position--;
-		ProcessXorState(data, prevStates, position);
+		//Only keep the pages that changed since the last key state (e.g ram pages that were written to, cpu/ppu registers)
+		const vector<uint8_t>* keyState = GetKeyState(prevStates, position - 1);
+		size_t keySize = keyState ? keyState->size() : 0;
+
+		uint32_t size = (uint32_t)data.size();
+		string delta;
+		delta.append((char*)&size, sizeof(uint32_t));
+		for(uint32_t start = 0, page = 0; start < size; start += PageSize, page++) {
+			uint32_t len = std::min(PageSize, size - start);
+			if(start + len <= keySize && memcmp(data.data() + start, keyState->data() + start, len) == 0) {
+				continue;
+			}
+			delta.append((char*)&page, sizeof(uint32_t));
+			delta.append(data.data() + start, len);
+		}
+
+		CompressionHelper::Compress(delta, 1, _saveStateData, CompressionType::Fast);
 	} else {
 		IsFullState = true;
+		_keyStateId = _nextKeyStateId++;
+		CompressionHelper::Compress(data, 1, _saveStateData, CompressionType::Fast);
+
+		//The next delta states will be based on this state, keep it in the cache
+		_keyStateCache.Id = _keyStateId;
+		_keyStateCache.Data.assign(data.begin(), data.end());
 	}
 
-	CompressionHelper::Compress(data, 1, _saveStateData);
 	FrameCount = 0;
 }
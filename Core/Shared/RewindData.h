@@ -8,10 +8,16 @@ class Emulator;
 class RewindData
 {
 private:
+	//Delta states only contain the pages of the state that differ from the previous key (full) state
+	static constexpr uint32_t PageSize = 256;
+
 	vector<uint8_t> _saveStateData;
 
-	template<typename T>
-	void ProcessXorState(T& data, deque<RewindData>& prevStates, int32_t position);
+	//Unique ID of a key state, used to find its uncompressed copy in the cache
+	uint64_t _keyStateId = 0;
+
+	const vector<uint8_t>* GetKeyState(deque<RewindData>& prevStates, int32_t position);
+	bool GetUncompressedState(vector<uint8_t>& data, deque<RewindData>& prevStates, int32_t position);
 
 public:
 	std::deque<ControlDeviceState> InputLogs[BaseControlDevice::PortCount];
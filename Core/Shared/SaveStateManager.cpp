@@ -3,6 +3,7 @@
 #include "Utilities/ZipWriter.h"
 #include "Utilities/ZipReader.h"
 #include "Utilities/PNGHelper.h"
+#include "Utilities/Serializer.h"
 #include "Shared/SaveStateManager.h"
 #include "Shared/MessageManager.h"
 #include "Shared/Emulator.h"
@@ -255,6 +256,34 @@ bool SaveStateManager::LoadState(int stateIndex)
 	return false;
 }
 
+unique_ptr<Serializer> SaveStateManager::SaveSnapshot()
+{
+	//In-memory snapshot of the console's state: unlike regular save states, there is no header or
+	//video data and no compression, and the raw format is used so it can be saved/reloaded quickly
+	Serializer saver(SaveStateManager::FileFormatVersion, true, SerializeFormat::Raw);
+	_emu->Serialize(saver);
+
+	unique_ptr<Serializer> snapshot(new Serializer(SaveStateManager::FileFormatVersion, false, SerializeFormat::Raw));
+	if(!snapshot->LoadFrom(std::move(saver.GetData()))) {
+		return nullptr;
+	}
+	return snapshot;
+}
+
+bool SaveStateManager::LoadSnapshot(Serializer& snapshot)
+{
+	if(!_emu->IsRunning() || !snapshot.IsValid()) {
+		return false;
+	} else if(_emu->GetGameClient()->Connected()) {
+		MessageManager::DisplayMessage("Netplay", "NetplayNotAllowed");
+		return false;
+	}
+
+	bool result = _emu->Deserialize(snapshot);
+	_emu->GetMovieManager()->Stop();
+	return result;
+}
+
 void SaveStateManager::SaveRecentGame(string romName, string romPath, string patchPath)
 {
 	if(_emu->GetSettings()->CheckFlag(EmulationFlags::ConsoleMode)) {
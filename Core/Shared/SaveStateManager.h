@@ -2,6 +2,7 @@
 #include "pch.h"
 
 class Emulator;
+class Serializer;
 struct RenderedFrame;
 
 class SaveStateManager
@@ -38,6 +39,9 @@ public:
 	bool LoadState(string filepath, bool showSuccessMessage = true);
 	bool LoadState(int stateIndex);
 
+	unique_ptr<Serializer> SaveSnapshot();
+	bool LoadSnapshot(Serializer& snapshot);
+
 	void SaveRecentGame(string romName, string romPath, string patchPath);
 	void LoadRecentGame(string filename, bool resetGame);
 
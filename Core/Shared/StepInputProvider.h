@@ -0,0 +1,35 @@
+#pragma once
+#include "pch.h"
+#include "Shared/Interfaces/IInputProvider.h"
+#include "Shared/BaseControlDevice.h"
+
+//Applies the inputs given to Emulator::Step() to the controllers (one button bitmask per port),
+//overriding whatever the key mappings would have set
+class StepInputProvider : public IInputProvider
+{
+private:
+	vector<uint32_t> _portButtons;
+
+public:
+	void SetButtons(const vector<uint32_t>& portButtons)
+	{
+		_portButtons = portButtons;
+	}
+
+	bool SetInput(BaseControlDevice* device) override
+	{
+		uint8_t port = device->GetPort();
+		if(port >= _portButtons.size()) {
+			return false;
+		}
+
+		device->ClearState();
+		uint32_t buttons = _portButtons[port];
+		for(uint8_t i = 0; buttons != 0; i++, buttons >>= 1) {
+			if(buttons & 0x01) {
+				device->SetBit(i);
+			}
+		}
+		return true;
+	}
+};
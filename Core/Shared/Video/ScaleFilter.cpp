@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Shared/Video/ScaleFilter.h"
+#include "Utilities/RowBandThreadPool.h"
 #include "Utilities/xBRZ/xbrz.h"
 #include "Utilities/HQX/hqx.h"
 #include "Utilities/Scale2x/scalebit.h"
@@ -60,10 +61,15 @@ uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, ui
 {
 	UpdateOutputBuffer(width, height);
 
+	//xBRZ and HQX can scale separate slices of the image in parallel
 	if(_scaleFilterType == ScaleFilterType::xBRZ) {
-		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB);
+		RowBandThreadPool::GetInstance().Run(height, 16, [=](uint32_t startRow, uint32_t endRow) {
+			xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB, xbrz::ScalerCfg(), startRow, endRow);
+		});
 	} else if(_scaleFilterType == ScaleFilterType::HQX) {
-		hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height);
+		RowBandThreadPool::GetInstance().Run(height, 16, [=](uint32_t startRow, uint32_t endRow) {
+			hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height, startRow, endRow);
+		});
 	} else if(_scaleFilterType == ScaleFilterType::Scale2x) {
 		scale(_filterScale, _outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
 	} else if(_scaleFilterType == ScaleFilterType::_2xSai) {
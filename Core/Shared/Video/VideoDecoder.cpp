@@ -15,13 +15,14 @@
 #include "Shared/InputHud.h"
 #include "Shared/RenderedFrame.h"
 #include "Shared/Video/SystemHud.h"
+#include "Shared/PerfCounters.h"
 #include "SNES/CartTypes.h"
 
 VideoDecoder::VideoDecoder(Emulator* emu)
 {
 	_emu = emu;
-	_frameChanged = false;
 	_stopFlag = false;
+	ResetFrameSlots();
 	_baseFrameSize = { 256, 239 };
 	_lastFrameSize = _baseFrameSize;
 }
@@ -92,6 +93,7 @@ void VideoDecoder::UpdateVideoFilter()
 
 void VideoDecoder::DecodeFrame(bool forRewind)
 {
+	PerfTimer timer(_emu->GetPerfCounters(), PerfCounterType::DecodeFrame);
 	UpdateVideoFilter();
 
 	bool isAudioPlayer = _emu->GetAudioPlayerHud() != nullptr;
@@ -143,8 +145,32 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 	
 	//Rewind manager will take care of sending the correct frame to the video renderer
 	_emu->GetRewindManager()->SendFrame(convertedFrame, forRewind);
+}
+
+void VideoDecoder::ResetFrameSlots()
+{
+	_writeSlot = 0;
+	_readSlot = 1;
+	_latestSlot = 2;
+	_decoding = false;
+}
+
+void VideoDecoder::SendFrameToDecodeThread(RenderedFrame& frame)
+{
+	//Copy the frame into the emulation thread's slot (the PPU reuses its buffers for the next frames)
+	FrameSlot& slot = _frameSlots[_writeSlot];
+	uint32_t bufferSize = frame.GetFrameBufferSize();
+	if(slot.Pixels.size() < bufferSize) {
+		slot.Pixels.resize(bufferSize);
+	}
+	memcpy(slot.Pixels.data(), frame.FrameBuffer, bufferSize * sizeof(uint16_t));
+
+	slot.Frame = frame;
+	slot.Frame.FrameBuffer = slot.Pixels.data();
 
-	_frameChanged = false;
+	//Publish it as the latest frame, and take back the previous latest slot (skipped if the decoder hadn't picked it up yet)
+	_writeSlot = _latestSlot.exchange(_writeSlot | NewFrameFlag) & 0x03;
+	_waitForFrame.Signal();
 }
 
 void VideoDecoder::DecodeThread()
@@ -152,14 +178,18 @@ void VideoDecoder::DecodeThread()
 	//This thread will decode the PPU's output (color ID to RGB, intensify r/g/b and produce a HD version of the frame if needed)
 	while(!_stopFlag.load()) {
 		//DecodeFrame returns the final ARGB frame we want to display in the emulator window
-		while(!_frameChanged) {
+		while(!(_latestSlot & NewFrameFlag)) {
 			_waitForFrame.Wait();
 			if(_stopFlag.load()) {
 				return;
 			}
 		}
 
+		_decoding = true;
+		_readSlot = _latestSlot.exchange(_readSlot) & 0x03;
+		_frame = _frameSlots[_readSlot].Frame;
 		DecodeFrame();
+		_decoding = false;
 	}
 }
 
@@ -170,7 +200,7 @@ uint32_t VideoDecoder::GetFrameCount()
 
 void VideoDecoder::WaitForAsyncFrameDecode()
 {
-	while(_frameChanged) {
+	while((_latestSlot & NewFrameFlag) || _decoding) {
 		//Spin until decode is done
 		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(15));
 	}
@@ -178,39 +208,49 @@ void VideoDecoder::WaitForAsyncFrameDecode()
 
 void VideoDecoder::UpdateFrame(RenderedFrame frame, bool sync, bool forRewind)
 {
-	if(_emu->IsRunAheadFrame()) {
+	if(_emu->IsRunAheadFrame() || frame.RenderingSkipped) {
 		return;
 	}
 
-	if(_frameChanged) {
-		//Last frame isn't done decoding yet - sometimes Signal() introduces a 25-30ms delay
-		while(_frameChanged) {
+	if(_emu->IsHeadless()) {
+		//No decode/render threads, keep the raw frame for GetRawFrame()
+		_frame = frame;
+		_frameCount++;
+		return;
+	}
+
+	if(sync || frame.Data) {
+		//Frames decoded on this thread (rewind) must wait for the decode thread to be idle, and so do
+		//frames with HD pack data, since the PPU only double-buffers that data
+		while((_latestSlot & NewFrameFlag) || _decoding) {
 			//Spin until decode is done
 		}
-		//At this point, we are sure that the decode thread is no longer busy
 	}
 
 	_emu->OnBeforeSendFrame();
 
-	_frame = frame;
 	if(sync) {
+		_frame = frame;
 		DecodeFrame(forRewind);
 	} else {
-		_frameChanged = true;
-		_waitForFrame.Signal();
+		SendFrameToDecodeThread(frame);
 	}
 	_frameCount++;
 }
 
 void VideoDecoder::StartThread()
 {
+	if(_emu->IsHeadless()) {
+		return;
+	}
+
 	auto lock = _stopStartLock.AcquireSafe();
 	if(!_decodeThread) {
 		_videoFilter.reset();
 		UpdateVideoFilter();
 		_videoFilter->SetBaseFrameInfo(_baseFrameSize);
 		_stopFlag = false;
-		_frameChanged = false;
+		ResetFrameSlots();
 		_frameCount = 0;
 		_waitForFrame.Reset();
 		
@@ -22,8 +22,23 @@ private:
 
 	SimpleLock _stopStartLock;
 	AutoResetEvent _waitForFrame;
-	
-	atomic<bool> _frameChanged;
+
+	//Frames are handed to the decode thread with triple buffering: the emulation thread copies the frame
+	//into its own slot and swaps it with the "latest" slot, and the decode thread swaps the latest slot
+	//with its own - the emulation thread never waits for the decoder, which always gets the newest frame
+	struct FrameSlot
+	{
+		RenderedFrame Frame;
+		vector<uint16_t> Pixels;
+	};
+
+	static constexpr uint8_t NewFrameFlag = 0x04;
+	FrameSlot _frameSlots[3];
+	atomic<uint8_t> _latestSlot;
+	uint8_t _writeSlot = 0;
+	uint8_t _readSlot = 1;
+	atomic<bool> _decoding;
+
 	atomic<bool> _stopFlag;
 	uint32_t _frameCount = 0;
 	bool _forceFilterUpdate = false;
@@ -40,6 +55,8 @@ private:
 	unique_ptr<RotateFilter> _rotateFilter;
 
 	void UpdateVideoFilter();
+	void ResetFrameSlots();
+	void SendFrameToDecodeThread(RenderedFrame& frame);
 
 	void DecodeThread();
 
@@ -60,6 +77,9 @@ public:
 	FrameInfo GetFrameInfo();
 	double GetLastFrameScale() { return _frame.Scale; }
 
+	//Last frame sent by the PPU, before any filtering (its buffer is only valid until the next frame)
+	RenderedFrame GetRawFrame() { return _frame; }
+
 	void UpdateFrame(RenderedFrame frame, bool sync, bool forRewind);
 
 	void WaitForAsyncFrameDecode();
@@ -44,6 +44,10 @@ void VideoRenderer::SetRendererSize(uint32_t width, uint32_t height)
 
 void VideoRenderer::StartThread()
 {
+	if(_emu->IsHeadless()) {
+		return;
+	}
+
 	if(!_renderThread) {
 		auto lock = _stopStartLock.AcquireSafe();
 		if(!_renderThread) {
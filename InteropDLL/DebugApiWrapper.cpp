@@ -58,11 +58,22 @@ extern "C"
 		_emu->InitDebugger();
 	}
 
+	DllExport void __stdcall SetScriptHostMode(bool enabled)
+	{
+		_emu->SetScriptHostMode(enabled);
+	}
+
 	DllExport void __stdcall ReleaseDebugger()
 	{
 		_emu->StopDebugger();
 	}
 
+	DllExport bool __stdcall IsDebuggerSupported()
+	{
+		//False when the core was built with MESEN_NO_DEBUGGER (the debugger, trace logger and scripts can't be used)
+		return Emulator::DebuggerEnabled;
+	}
+
 	DllExport bool __stdcall IsDebuggerRunning()
 	{
 		return _emu->GetDebugger().GetDebugger() != nullptr;
@@ -82,7 +93,9 @@ extern "C"
 	DllExport void __stdcall ClearExecutionTrace() { WithDebugger(void, ClearExecutionTrace()); }
 
 	DllExport void __stdcall StartLogTraceToFile(const char* filename) { WithDebugger(void, GetTraceLogFileSaver()->StartLogging(filename)); }
-	DllExport void __stdcall StopLogTraceToFile() { WithDebugger(void, GetTraceLogFileSaver()->StopLogging()); }
+	DllExport void __stdcall StopLogTraceToFile() { WithDebugger(void, StopTraceLog()); }
+	DllExport void __stdcall StartLogTraceToBinaryFile(const char* filename, uint32_t maxFileSizeMb) { WithDebugger(void, StartBinaryTraceLog(filename, (uint64_t)maxFileSizeMb * 1024 * 1024)); }
+	DllExport bool __stdcall DecodeBinaryTraceLog(const char* inputFile, const char* outputFile) { return WithDebugger(bool, DecodeBinaryTraceLog(inputFile, outputFile)); }
 
 	DllExport void __stdcall SetBreakpoints(Breakpoint breakpoints[], uint32_t length) { WithDebugger(void, SetBreakpoints(breakpoints, length)); }
 	
@@ -105,6 +118,9 @@ extern "C"
 	}
 
 	DllExport void __stdcall ResetProfiler(CpuType cpuType) { WithToolVoid(GetCallstackManager(cpuType), GetProfiler()->Reset()); }
+	DllExport void __stdcall StartProfilerSampling(CpuType cpuType, uint32_t sampleInterval, uint32_t maxSamples) { WithToolVoid(GetCallstackManager(cpuType), GetProfiler()->StartSampling(sampleInterval, maxSamples)); }
+	DllExport void __stdcall StopProfilerSampling(CpuType cpuType) { WithToolVoid(GetCallstackManager(cpuType), GetProfiler()->StopSampling()); }
+	DllExport bool __stdcall ExportProfilerFlameGraph(CpuType cpuType, char* filename) { return WithTool(bool, GetCallstackManager(cpuType), GetProfiler()->ExportFlameGraph(filename)); }
 
 	DllExport void __stdcall GetConsoleState(BaseState& state, ConsoleType consoleType) { WithDebugger(void, GetConsoleState(state, consoleType)); }
 	DllExport void __stdcall GetCpuState(BaseState& state, CpuType cpuType) { WithDebugger(void, GetCpuState(state, cpuType)); }
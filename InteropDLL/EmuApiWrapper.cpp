@@ -12,6 +12,7 @@
 #include "Core/Shared/TimingInfo.h"
 #include "Core/Shared/CheatManager.h"
 #include "Core/Shared/DebuggerRequest.h"
+#include "Core/Shared/PerfCounters.h"
 #include "Core/Netplay/GameClient.h"
 #include "Core/Netplay/GameServer.h"
 #include "Utilities/ArchiveReader.h"
@@ -259,6 +260,22 @@ extern "C" {
 	
 	DllExport uint32_t __stdcall GetGameMemorySize(MemoryType type) { return _emu->GetMemory(type).Size; }
 
+	DllExport uint32_t __stdcall GetPerfStats(PerfCounterStats* stats, uint32_t maxCount)
+	{
+		//Returns the number of counters written to the array (in PerfCounterType order)
+		if(!stats) {
+			return 0;
+		}
+
+		PerfCounterStats counters[PerfCounters::CounterTypeCount];
+		_emu->GetPerfCounters()->GetStats(counters);
+		uint32_t count = std::min<uint32_t>(maxCount, PerfCounters::CounterTypeCount);
+		memcpy(stats, counters, count * sizeof(PerfCounterStats));
+		return count;
+	}
+
+	DllExport void __stdcall ResetPerfStats() { _emu->GetPerfCounters()->Reset(); }
+
 	DllExport void __stdcall ClearCheats() { _emu->GetCheatManager()->ClearCheats(); }
 	DllExport void __stdcall SetCheats(CheatCode codes[], uint32_t length) { _emu->GetCheatManager()->SetCheats(codes, length); }
 	DllExport bool __stdcall GetConvertedCheat(CheatCode input, InternalCheatCode& output) { return _emu->GetCheatManager()->GetConvertedCheat(input, output); }
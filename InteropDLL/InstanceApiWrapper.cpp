@@ -0,0 +1,416 @@
+#include "Common.h"
+#include "Core/Shared/Emulator.h"
+#include "Core/Shared/EmuSettings.h"
+#include "Core/Shared/SaveStateManager.h"
+#include "Core/Shared/Video/VideoDecoder.h"
+#include "Core/Shared/Audio/SoundMixer.h"
+#include "Core/Shared/PerfCounters.h"
+#include "Utilities/VirtualFile.h"
+#include "Utilities/Serializer.h"
+#include "Utilities/SimpleLock.h"
+#include "Utilities/FolderUtilities.h"
+#include "Core/Shared/DebuggerRequest.h"
+#include "Core/Debugger/Debugger.h"
+#include "Core/Debugger/ScriptManager.h"
+#include "InteropNotificationListeners.h"
+
+extern unique_ptr<Emulator> _emu;
+
+//Independent emulator instances, used to run several emulators in the same process (e.g to run
+//multiple environments in parallel). Each instance is referenced by an opaque handle (the
+//Emulator pointer), which is validated against this list before each call. Each call keeps a
+//reference to the instance while it runs, so an instance released by another thread in the
+//meantime is only stopped and destroyed once the calls that use it have returned.
+static SimpleLock _instanceLock;
+static vector<shared_ptr<Emulator>> _instances;
+
+//Rom files loaded by instances are kept in memory and shared between all instances, so creating
+//many instances for the same game only reads (and decompresses/patches) the file once.
+//Files that were modified since they were cached are read again, and the least recently used
+//files are removed from the cache when its total size goes above MaxRomCacheSize.
+struct CachedRom
+{
+	VirtualFile File;
+	int64_t ModificationTime;
+	uint64_t LastUsed;
+};
+
+static constexpr size_t MaxRomCacheSize = 256 * 1024 * 1024;
+static SimpleLock _romCacheLock;
+static unordered_map<string, CachedRom> _romCache;
+static uint64_t _romCacheCounter = 0;
+
+static InteropNotificationListeners _listeners;
+
+static shared_ptr<Emulator> GetInstance(Emulator* handle)
+{
+	auto lock = _instanceLock.AcquireSafe();
+	for(shared_ptr<Emulator>& emu : _instances) {
+		if(emu.get() == handle) {
+			return emu;
+		}
+	}
+	return nullptr;
+}
+
+static VirtualFile GetCachedRom(const string& filename)
+{
+	VirtualFile romFile = filename;
+	int64_t modificationTime = FolderUtilities::GetFileModificationTime(romFile.GetFilePath());
+
+	auto lock = _romCacheLock.AcquireSafe();
+	auto result = _romCache.find(filename);
+	if(result != _romCache.end()) {
+		if(result->second.ModificationTime == modificationTime) {
+			result->second.LastUsed = ++_romCacheCounter;
+			return result->second.File;
+		}
+		_romCache.erase(result);
+	}
+
+	if(!romFile.IsValid()) {
+		return romFile;
+	}
+
+	//Load the file's content in memory before caching it
+	romFile.LoadFile();
+
+	size_t cacheSize = romFile.GetSize();
+	for(auto& entry : _romCache) {
+		cacheSize += entry.second.File.GetSize();
+	}
+	while(cacheSize > MaxRomCacheSize && !_romCache.empty()) {
+		auto oldest = _romCache.begin();
+		for(auto it = _romCache.begin(); it != _romCache.end(); it++) {
+			if(it->second.LastUsed < oldest->second.LastUsed) {
+				oldest = it;
+			}
+		}
+		cacheSize -= oldest->second.File.GetSize();
+		_romCache.erase(oldest);
+	}
+
+	_romCache[filename] = { romFile, modificationTime, ++_romCacheCounter };
+	return romFile;
+}
+
+static void ReleaseInstance(Emulator* emu)
+{
+	emu->Stop(false, true);
+	emu->Release();
+	delete emu;
+}
+
+extern "C" {
+	DllExport Emulator* __stdcall EmuInstanceCreate(bool copySettings, bool headless)
+	{
+		shared_ptr<Emulator> emu(new Emulator(), ReleaseInstance);
+		emu->Initialize(false, headless);
+		if(copySettings && _emu) {
+			emu->GetSettings()->CopySettings(*_emu->GetSettings());
+		}
+
+		Emulator* handle = emu.get();
+		auto lock = _instanceLock.AcquireSafe();
+		_instances.push_back(std::move(emu));
+		return handle;
+	}
+
+	DllExport void __stdcall EmuInstanceRelease(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu;
+		{
+			auto lock = _instanceLock.AcquireSafe();
+			for(auto it = _instances.begin(); it != _instances.end(); it++) {
+				if(it->get() == handle) {
+					emu = std::move(*it);
+					_instances.erase(it);
+					break;
+				}
+			}
+		}
+
+		//The instance is stopped and destroyed (by ReleaseInstance) when the last reference to it is
+		//released: here, or at the end of a call still using the instance on another thread
+		emu.reset();
+	}
+
+	DllExport uint32_t __stdcall EmuInstanceGetCount()
+	{
+		auto lock = _instanceLock.AcquireSafe();
+		return (uint32_t)_instances.size();
+	}
+
+	DllExport void __stdcall EmuInstanceClearRomCache()
+	{
+		auto lock = _romCacheLock.AcquireSafe();
+		_romCache.clear();
+	}
+
+	DllExport bool __stdcall EmuInstanceLoadRom(Emulator* handle, char* filename, char* patchFile)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu) {
+			return false;
+		}
+
+		VirtualFile romFile = GetCachedRom(filename);
+		return emu->LoadRom(romFile, patchFile ? (VirtualFile)patchFile : VirtualFile());
+	}
+
+	DllExport bool __stdcall EmuInstanceIsRunning(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		return emu ? emu->IsRunning() : false;
+	}
+
+	DllExport void __stdcall EmuInstanceStop(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->Stop(true, true);
+		}
+	}
+
+	DllExport void __stdcall EmuInstancePause(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->Pause();
+		}
+	}
+
+	DllExport void __stdcall EmuInstanceResume(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->Resume();
+		}
+	}
+
+	DllExport bool __stdcall EmuInstanceIsPaused(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		return emu ? emu->IsPaused() : false;
+	}
+
+	DllExport void __stdcall EmuInstanceReset(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu && emu->IsRunning()) {
+			emu->Reset();
+		}
+	}
+
+	DllExport void __stdcall EmuInstanceSetStepMode(Emulator* handle, bool enabled)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->SetStepMode(enabled);
+		}
+	}
+
+	DllExport void __stdcall EmuInstanceSetScriptHostMode(Emulator* handle, bool enabled)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->SetScriptHostMode(enabled);
+		}
+	}
+
+	DllExport void __stdcall EmuInstanceSetSkipRendering(Emulator* handle, bool skip)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->SetSkipRendering(skip);
+		}
+	}
+
+	DllExport void __stdcall EmuInstanceSetAudioSinkMode(Emulator* handle, AudioSinkMode mode)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->GetSoundMixer()->SetSinkMode(mode);
+		}
+	}
+
+	DllExport uint32_t __stdcall EmuInstanceReadAudioSamples(Emulator* handle, int16_t* buffer, uint32_t bufferSize, uint32_t* sampleRate)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu) {
+			return 0;
+		}
+
+		//Returns the number of values (2 per stereo sample) written to the buffer - samples that don't
+		//fit in the buffer are kept for the next call
+		vector<int16_t> samples;
+		uint32_t rate = emu->GetSoundMixer()->ReadCapturedSamples(samples, buffer ? bufferSize : 0);
+		if(sampleRate) {
+			*sampleRate = rate;
+		}
+
+		uint32_t count = (uint32_t)samples.size();
+		if(count > 0) {
+			memcpy(buffer, samples.data(), count * sizeof(int16_t));
+		}
+		return count;
+	}
+
+	DllExport bool __stdcall EmuInstanceStep(Emulator* handle, uint32_t frameCount, uint32_t* portButtons, uint32_t portCount)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu) {
+			return false;
+		}
+
+		vector<uint32_t> buttons;
+		if(portButtons) {
+			buttons.assign(portButtons, portButtons + portCount);
+		}
+		return emu->Step(frameCount, buttons);
+	}
+
+	DllExport void __stdcall EmuInstanceSetEmulationSpeed(Emulator* handle, uint32_t speed)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->GetSettings()->GetEmulationConfig().EmulationSpeed = speed;
+		}
+	}
+
+	DllExport uint32_t __stdcall EmuInstanceGetFrameCount(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		return emu && emu->IsRunning() ? emu->GetFrameCount() : 0;
+	}
+
+	DllExport uint32_t __stdcall EmuInstanceGetGameMemorySize(Emulator* handle, MemoryType type)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		return emu ? emu->GetMemory(type).Size : 0;
+	}
+
+	DllExport uint32_t __stdcall EmuInstanceGetPerfStats(Emulator* handle, PerfCounterStats* stats, uint32_t maxCount)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu || !stats) {
+			return 0;
+		}
+
+		PerfCounterStats counters[PerfCounters::CounterTypeCount];
+		emu->GetPerfCounters()->GetStats(counters);
+		uint32_t count = std::min<uint32_t>(maxCount, PerfCounters::CounterTypeCount);
+		memcpy(stats, counters, count * sizeof(PerfCounterStats));
+		return count;
+	}
+
+	DllExport void __stdcall EmuInstanceResetPerfStats(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(emu) {
+			emu->GetPerfCounters()->Reset();
+		}
+	}
+
+	DllExport FrameInfo __stdcall EmuInstanceGetRawFrame(Emulator* handle, uint16_t* buffer, uint32_t bufferSize)
+	{
+		FrameInfo size = {};
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu || !emu->IsRunning()) {
+			return size;
+		}
+
+		auto lock = emu->AcquireLock();
+		RenderedFrame frame = emu->GetVideoDecoder()->GetRawFrame();
+		if(!frame.FrameBuffer) {
+			return size;
+		}
+
+		size.Width = frame.Width;
+		size.Height = frame.Height;
+		if(buffer && bufferSize >= frame.GetFrameBufferSize()) {
+			memcpy(buffer, frame.FrameBuffer, frame.GetFrameBufferSize() * sizeof(uint16_t));
+		}
+		return size;
+	}
+
+	DllExport bool __stdcall EmuInstanceSaveStateFile(Emulator* handle, char* filepath)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		return emu ? emu->GetSaveStateManager()->SaveState(filepath, false) : false;
+	}
+
+	DllExport bool __stdcall EmuInstanceLoadStateFile(Emulator* handle, char* filepath)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		return emu ? emu->GetSaveStateManager()->LoadState(filepath, false) : false;
+	}
+
+	DllExport Serializer* __stdcall EmuInstanceSaveSnapshot(Emulator* handle)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu || !emu->IsRunning()) {
+			return nullptr;
+		}
+
+		auto lock = emu->AcquireLock();
+		return emu->GetSaveStateManager()->SaveSnapshot().release();
+	}
+
+	DllExport bool __stdcall EmuInstanceLoadSnapshot(Emulator* handle, Serializer* snapshot)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu || !snapshot) {
+			return false;
+		}
+
+		auto lock = emu->AcquireLock();
+		return emu->GetSaveStateManager()->LoadSnapshot(*snapshot);
+	}
+
+	DllExport void __stdcall EmuInstanceReleaseSnapshot(Serializer* snapshot)
+	{
+		delete snapshot;
+	}
+
+	DllExport int32_t __stdcall EmuInstanceLoadScript(Emulator* handle, char* name, char* path, char* content, int32_t scriptId)
+	{
+		//Scripts run in the instance's own debugger/script manager, sharing the process' Python runtime
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu) {
+			return -1;
+		}
+
+		DebuggerRequest dbgRequest = emu->GetDebugger(true);
+		Debugger* debugger = dbgRequest.GetDebugger();
+		if(!debugger || !debugger->GetScriptManager()) {
+			return -1;
+		}
+		return debugger->GetScriptManager()->LoadScript(name, path, content, scriptId);
+	}
+
+	DllExport void __stdcall EmuInstanceRemoveScript(Emulator* handle, int32_t scriptId)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		if(!emu) {
+			return;
+		}
+
+		DebuggerRequest dbgRequest = emu->GetDebugger(true);
+		Debugger* debugger = dbgRequest.GetDebugger();
+		if(debugger && debugger->GetScriptManager()) {
+			debugger->GetScriptManager()->RemoveScript(scriptId);
+		}
+	}
+
+	DllExport INotificationListener* __stdcall EmuInstanceRegisterNotificationCallback(Emulator* handle, NotificationListenerCallback callback)
+	{
+		shared_ptr<Emulator> emu = GetInstance(handle);
+		return emu ? _listeners.RegisterNotificationCallback(callback, emu.get()) : nullptr;
+	}
+
+	DllExport void __stdcall EmuInstanceUnregisterNotificationCallback(INotificationListener* listener)
+	{
+		_listeners.UnregisterNotificationCallback(listener);
+	}
+}
@@ -6,26 +6,85 @@ def read8(address) -> int:
 	"""Reads an 8-bit value from the specified memory address."""
 	raise NotImplementedError()
 
-def registerFrameMemory(type, addresses) -> int:
+def readRange(type, start, length) -> bytes:
+	"""Reads a range of 8-bit values from memory.
+		type: memory type (e.g. memoryType.nesMemory)
+		start: first address to read
+		length: number of bytes to read
+		returns: bytes containing the values (addresses past the end of the memory read as 0)"""
+	raise NotImplementedError()
+
+def registerFrameMemory(type, addresses):
 	"""Registers memory addresses (and sizes) to be tracked and updated every frame.
 		type: memory type (e.g. memoryType.nesMemory)
 		addresses: list of addresses to track
-		returns: handle to the registered memory (used to unregister the memory later), which is also the pointer to the first address in the registered memory block"""
+		returns: buffer holding one uint8 per address (used to unregister the memory later).  It supports the buffer protocol, e.g. numpy.asarray(buffer) returns an array that is updated every frame without any copy"""
 	raise NotImplementedError()
 
 def unregisterFrameMemory(handle):
 	"""Unregisters frame memory updates.
-		handle: handle returned by registerFrameMemory"""
+		handle: buffer returned by registerFrameMemory"""
 	raise NotImplementedError()
 
-def registerScreenMemory() -> int:
-	"""Registers screen memory addresses (and sizes) to be tracked and updated every frame.
-		returns: handle to the registered memory (used to unregister the memory later), which is also the pointer to the first address in the registered memory block"""
+def registerScreenMemory(format = 0, scale = 1):
+	"""Registers screen memory to be updated every frame.
+		format: screen format (e.g. screenFormat.rgb)
+			rgb: output of the video filter, height x width x 4 uint8 (BGRA)
+			raw: unfiltered PPU output (e.g. palette indexes on the NES), height x width uint16
+			grayscale: output of the video filter in grayscale, (height / scale) x (width / scale) uint8
+		scale: downscale factor, only used by the grayscale format
+		returns: buffer holding the screen's pixels (used to unregister the memory later).  It supports the buffer protocol, e.g. numpy.asarray(buffer) returns an array that is updated every frame without any copy.
+			If the resolution changes (e.g. SNES high resolution modes), a new buffer is allocated and must be obtained by calling registerScreenMemory again"""
 	raise NotImplementedError()
 
 def unregisterScreenMemory(handle):
 	"""Unregisters screen memory updates.
-		handle: handle returned by registerScreenMemory"""
+		handle: buffer returned by registerScreenMemory"""
+	raise NotImplementedError()
+
+def skipRendering(skip):
+	"""Skips drawing the frames' pixels, e.g. to run faster when only the memory is observed.  The emulation itself is unaffected.
+		skip: True to stop drawing frames (starting with the next frame), False to draw them again
+			The screen memory buffers keep their last content while frames are skipped"""
+	raise NotImplementedError()
+
+def setAudioSink(mode):
+	"""Sets what is done with the console's audio samples.  The sound chips keep running normally in all modes.
+		mode: audioSink.default to play the audio, audioSink.drop to discard it without resampling/effects,
+			audioSink.capture to keep the raw samples for readAudioSamples() instead of playing them"""
+	raise NotImplementedError()
+
+def readAudioSamples() -> (bytes, int):
+	"""Returns the samples captured since the last call (audioSink.capture mode only) and their sample rate.
+		The samples are interleaved 16-bit signed stereo values (left, right), before any resampling or effects.
+		At most ~2 seconds of audio is kept between calls."""
+	raise NotImplementedError()
+
+def getPerfStats() -> dict:
+	"""Returns the host time spent in the emulator's main steps, to find out where the time goes.
+		Keys: runFrame, scriptEvent, serialize, deserialize, decodeFrame, playAudioBuffer
+		Each value is a dict with: count, totalNs, minNs, maxNs and histogram
+			(histogram[i] is the number of calls that took between 2^i and 2^(i+1)-1 ns)
+		A step's time includes the steps it calls (e.g. runFrame includes the script events)"""
+	raise NotImplementedError()
+
+def resetPerfStats():
+	"""Resets the values returned by getPerfStats."""
+	raise NotImplementedError()
+
+def addMemoryCallback(callback, type, start, end = -1, cpuType = -1, memType = -1):
+	"""Adds a memory callback, called with (address, value) when the memory is read/written/executed.  Returning an integer from the callback overrides the value.
+		callback: function to call
+		type: type of memory operation (e.g. callbackType.write)
+		start: first address of the range to watch
+		end: last address of the range to watch (defaults to start)
+		cpuType: cpu to watch (defaults to the main cpu)
+		memType: memory type of the addresses (defaults to the main cpu's memory, e.g. memoryType.nesMemory)"""
+	raise NotImplementedError()
+
+def removeMemoryCallback(callback, type, start, end = -1, cpuType = -1, memType = -1):
+	"""Removes a memory callback.  The arguments must match the ones given to addMemoryCallback.
+		returns: True if the callback was removed"""
 	raise NotImplementedError()
 
 def addEventCallback(callback, eventType):
@@ -45,6 +104,28 @@ def loadSaveState(filename):
 		filename: path to the save state file"""
 	raise NotImplementedError()
 
+def saveState():
+	"""Creates an in-memory save state.  The state is taken at the start of the next instruction.
+		returns: handle to the save state (used with loadState and stateToBytes)"""
+	raise NotImplementedError()
+
+def loadState(handle):
+	"""Loads an in-memory save state.  The state is loaded at the start of the next instruction.
+		handle: handle returned by saveState or stateFromBytes"""
+	raise NotImplementedError()
+
+def stateToBytes(handle) -> bytes:
+	"""Gets the content of an in-memory save state.
+		handle: handle returned by saveState
+		returns: the save state's data, or None if the state has not been taken yet"""
+	raise NotImplementedError()
+
+def stateFromBytes(data : bytes):
+	"""Creates an in-memory save state from data returned by stateToBytes.
+		data: the save state's data
+		returns: handle to the save state (used with loadState)"""
+	raise NotImplementedError()
+
 def setInput(port, subport, input : []):
 	"""Sets input for a controller.
 		port: controller port (0-3)
@@ -108,6 +189,30 @@ class memoryType:
 
 memoryType = memoryType()
 
+class callbackType:
+	def __init__(self):
+		self.read = 0
+		self.write = 1
+		self.exec = 2
+
+callbackType = callbackType()
+
+class screenFormat:
+	def __init__(self):
+		self.rgb = 0
+		self.raw = 1
+		self.grayscale = 2
+
+screenFormat = screenFormat()
+
+class audioSink:
+	def __init__(self):
+		self.default = 0
+		self.drop = 1
+		self.capture = 2
+
+audioSink = audioSink()
+
 class eventType:
 	def __init__(self):
 		self.nmi = 0
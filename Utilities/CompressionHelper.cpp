@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "CompressionHelper.h"
+#include "LzCodec.h"
+#include "miniz.h"
+#if _DEBUG
+#include <assert.h>
+#endif
+
+void CompressionHelper::CompressBlock(const uint8_t* data, uint32_t size, CompressionType type, int compressionLevel, vector<uint8_t>& output)
+{
+	size_t start = output.size();
+	size_t headerSize = sizeof(uint32_t) * 2;
+	size_t maxSize = type == CompressionType::Fast ? LzCodec::GetMaxCompressedSize(size) : compressBound((unsigned long)size);
+	output.resize(start + headerSize + maxSize);
+
+	uint8_t* compressedData = output.data() + start + headerSize;
+	size_t compressedSize;
+	if(type == CompressionType::Fast) {
+		compressedSize = LzCodec::Compress(data, size, compressedData);
+	} else {
+		unsigned long deflateSize = (unsigned long)maxSize;
+		compress2(compressedData, &deflateSize, data, (unsigned long)size, compressionLevel);
+		compressedSize = deflateSize;
+	}
+
+#if _DEBUG
+	if(type == CompressionType::Fast) {
+		//Check that the data decompresses back to the original
+		static bool testsDone = false;
+		if(!testsDone) {
+			testsDone = true;
+			LzCodec::RunTests();
+		}
+
+		vector<uint8_t> decompressed(size);
+		bool result = LzCodec::Decompress(compressedData, compressedSize, decompressed.data(), size);
+		assert(result && memcmp(decompressed.data(), data, size) == 0);
+	}
+#endif
+
+	uint32_t compSize = (uint32_t)compressedSize;
+	memcpy(output.data() + start, &size, sizeof(uint32_t));
+	memcpy(output.data() + start + sizeof(uint32_t), &compSize, sizeof(uint32_t));
+	output.resize(start + headerSize + compressedSize);
+}
+
+bool CompressionHelper::DecompressBlock(const uint8_t* data, uint32_t compressedSize, CompressionType type, vector<uint8_t>& output, uint32_t decompressedSize)
+{
+	if(decompressedSize >= MaxSize || compressedSize >= MaxSize) {
+		return false;
+	}
+
+	output.resize(decompressedSize);
+	if(type == CompressionType::Fast) {
+		return LzCodec::Decompress(data, compressedSize, output.data(), decompressedSize);
+	} else if(type == CompressionType::Deflate) {
+		unsigned long decompSize = decompressedSize;
+		return uncompress(output.data(), &decompSize, data, compressedSize) == MZ_OK;
+	}
+	return false;
+}
+
+void CompressionHelper::Compress(const uint8_t* data, uint32_t size, CompressionType type, int compressionLevel, vector<uint8_t>& output)
+{
+	output.push_back((uint8_t)type);
+	CompressBlock(data, size, type, compressionLevel, output);
+}
+
+void CompressionHelper::Compress(const string& data, int compressionLevel, vector<uint8_t>& output, CompressionType type)
+{
+	Compress((const uint8_t*)data.data(), (uint32_t)data.size(), type, compressionLevel, output);
+}
+
+bool CompressionHelper::Decompress(const vector<uint8_t>& input, vector<uint8_t>& output)
+{
+	size_t headerSize = 1 + sizeof(uint32_t) * 2;
+	if(input.size() < headerSize) {
+		return false;
+	}
+
+	uint32_t decompressedSize;
+	uint32_t compressedSize;
+	memcpy(&decompressedSize, input.data() + 1, sizeof(uint32_t));
+	memcpy(&compressedSize, input.data() + 1 + sizeof(uint32_t), sizeof(uint32_t));
+	if(compressedSize > input.size() - headerSize) {
+		return false;
+	}
+
+	return DecompressBlock(input.data() + headerSize, compressedSize, (CompressionType)input[0], output, decompressedSize);
+}
@@ -1,44 +1,26 @@
 #pragma once
 #include "pch.h"
-#include "miniz.h"
+
+//Stored in the compressed data's header - 0 and 1 match the "is compressed" flag used by older save states
+enum class CompressionType : uint8_t
+{
+	None = 0,
+	Deflate = 1,
+	Fast = 2
+};
 
 class CompressionHelper
 {
 public:
-	static void Compress(string data, int compressionLevel, vector<uint8_t>& output)
-	{
-		unsigned long compressedSize = compressBound((unsigned long)data.size());
-		uint8_t* compressedData = new uint8_t[compressedSize];
-		compress2(compressedData, &compressedSize, (unsigned char*)data.c_str(), (unsigned long)data.size(), compressionLevel);
-
-		uint32_t size = (uint32_t)compressedSize;
-		uint32_t originalSize = (uint32_t)data.size();
-		output.insert(output.end(), (char*)&originalSize, (char*)&originalSize + sizeof(uint32_t));
-		output.insert(output.end(), (char*)&size, (char*)&size + sizeof(uint32_t));
-		output.insert(output.end(), (char*)compressedData, (char*)compressedData + compressedSize);
-		delete[] compressedData;
-	}
-
-	static bool Decompress(vector<uint8_t>& input, vector<uint8_t>& output)
-	{
-		uint32_t decompressedSize;
-		uint32_t compressedSize;
-
-		memcpy(&decompressedSize, input.data(), sizeof(uint32_t));
-		memcpy(&compressedSize, input.data() + sizeof(uint32_t), sizeof(uint32_t));
-
-		if(decompressedSize >= 1024 * 1024 * 10 || compressedSize >= 1024 * 1024 * 10) {
-			//Limit to 10mb the data's size
-			return false;
-		}
-
-		output.resize(decompressedSize, 0);
-
-		unsigned long decompSize = decompressedSize;
-		if(uncompress(output.data(), &decompSize, input.data() + sizeof(uint32_t)*2, (unsigned long)input.size() - sizeof(uint32_t) * 2) != MZ_OK) {
-			return false;
-		}
-
-		return true;
-	}
-};
\ No newline at end of file
+	//Limit to 10mb the data's size
+	static constexpr uint32_t MaxSize = 1024 * 1024 * 10;
+
+	//Compresses the data with the given codec and appends it to the output, as: uint32 original size, uint32 compressed size, data
+	static void CompressBlock(const uint8_t* data, uint32_t size, CompressionType type, int compressionLevel, vector<uint8_t>& output);
+	static bool DecompressBlock(const uint8_t* data, uint32_t compressedSize, CompressionType type, vector<uint8_t>& output, uint32_t decompressedSize);
+
+	//Format: uint8 compression type, uint32 original size, uint32 compressed size, data
+	static void Compress(const uint8_t* data, uint32_t size, CompressionType type, int compressionLevel, vector<uint8_t>& output);
+	static void Compress(const string& data, int compressionLevel, vector<uint8_t>& output, CompressionType type = CompressionType::Deflate);
+	static bool Decompress(const vector<uint8_t>& input, vector<uint8_t>& output);
+};
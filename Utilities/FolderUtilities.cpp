@@ -225,6 +225,14 @@ string FolderUtilities::GetFolderName(string filepath)
 	return fs::u8path(filepath).remove_filename().u8string();
 }
 
+int64_t FolderUtilities::GetFileModificationTime(string filepath)
+{
+	//Returns -1 if the file doesn't exist (the value is only meant to be compared with other values returned by this function)
+	std::error_code errorCode;
+	auto time = fs::last_write_time(fs::u8path(filepath), errorCode);
+	return errorCode ? -1 : (int64_t)time.time_since_epoch().count();
+}
+
 string FolderUtilities::CombinePath(string folder, string filename)
 {
 	//Windows supports forward slashes for paths, too.  And fs::u8path is abnormally slow.
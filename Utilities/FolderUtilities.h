@@ -36,6 +36,7 @@ public:
 	static string GetFilename(string filepath, bool includeExtension);
 	static string GetExtension(string filename);
 	static string GetFolderName(string filepath);
+	static int64_t GetFileModificationTime(string filepath);
 
 	static void CreateFolder(string folder);
 
@@ -0,0 +1,256 @@
+#include "pch.h"
+#include "LzCodec.h"
+
+static constexpr uint32_t HashBits = 14;
+
+static __forceinline uint32_t Read32(const uint8_t* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static __forceinline uint32_t Hash(uint32_t value)
+{
+	return (value * 2654435761u) >> (32 - HashBits);
+}
+
+void LzCodec::WriteLength(uint8_t*& out, size_t length)
+{
+	//Lengths >= 15 are stored in the token as 15, followed by as many bytes as needed (255 = more bytes follow)
+	for(length -= 15; length >= 255; length -= 255) {
+		*out++ = 255;
+	}
+	*out++ = (uint8_t)length;
+}
+
+size_t LzCodec::Compress(const uint8_t* data, size_t size, uint8_t* output)
+{
+	uint8_t* out = output;
+	const uint8_t* anchor = data;
+	const uint8_t* end = data + size;
+
+	if(size > MatchSearchLimit) {
+		//Offset of the last position that had each hash (thread local to avoid reallocating it for every call)
+		static thread_local vector<uint32_t> table(1 << HashBits);
+		std::fill(table.begin(), table.end(), 0);
+
+		//The last match must start MatchSearchLimit bytes before the end, and the last LastLiterals bytes are always literals
+		const uint8_t* searchEnd = end - MatchSearchLimit;
+		const uint8_t* matchEnd = end - LastLiterals;
+		const uint8_t* pos = data + 1;
+		uint32_t misses = 0;
+
+		while(pos < searchEnd) {
+			uint32_t value = Read32(pos);
+			uint32_t& entry = table[Hash(value)];
+			const uint8_t* ref = data + entry;
+			entry = (uint32_t)(pos - data);
+
+			if(ref >= pos || pos - ref > MaxOffset || Read32(ref) != value) {
+				//Skip faster through data that doesn't compress
+				pos += 1 + (misses++ >> 6);
+				continue;
+			}
+			misses = 0;
+
+			//Extend the match forward, then backward
+			const uint8_t* matchPos = pos + MinMatch;
+			const uint8_t* refPos = ref + MinMatch;
+			while(matchPos + 8 <= matchEnd && memcmp(matchPos, refPos, 8) == 0) {
+				matchPos += 8;
+				refPos += 8;
+			}
+			while(matchPos < matchEnd && *matchPos == *refPos) {
+				matchPos++;
+				refPos++;
+			}
+			while(pos > anchor && ref > data && pos[-1] == ref[-1]) {
+				pos--;
+				ref--;
+			}
+
+			size_t literalLength = pos - anchor;
+			size_t matchLength = matchPos - pos - MinMatch;
+
+			uint8_t* token = out++;
+			*token = (uint8_t)((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchLength, 15));
+			if(literalLength >= 15) {
+				WriteLength(out, literalLength);
+			}
+			memcpy(out, anchor, literalLength);
+			out += literalLength;
+
+			uint16_t offset = (uint16_t)(pos - ref);
+			*out++ = (uint8_t)offset;
+			*out++ = (uint8_t)(offset >> 8);
+			if(matchLength >= 15) {
+				WriteLength(out, matchLength);
+			}
+
+			pos = matchPos;
+			anchor = pos;
+			if(pos - 2 > data && pos < searchEnd) {
+				table[Hash(Read32(pos - 2))] = (uint32_t)(pos - 2 - data);
+			}
+		}
+	}
+
+	//Last sequence, only contains literals
+	size_t literalLength = end - anchor;
+	*out++ = (uint8_t)(std::min<size_t>(literalLength, 15) << 4);
+	if(literalLength >= 15) {
+		WriteLength(out, literalLength);
+	}
+	if(literalLength > 0) {
+		memcpy(out, anchor, literalLength);
+		out += literalLength;
+	}
+
+	return out - output;
+}
+
+static __forceinline bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length)
+{
+	uint8_t value;
+	do {
+		if(in >= end) {
+			return false;
+		}
+		value = *in++;
+		length += value;
+	} while(value == 255);
+	return true;
+}
+
+bool LzCodec::Decompress(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize)
+{
+	const uint8_t* in = data;
+	const uint8_t* end = data + size;
+	uint8_t* out = output;
+	uint8_t* outEnd = output + outputSize;
+
+	while(in < end) {
+		uint8_t token = *in++;
+
+		size_t literalLength = token >> 4;
+		if(literalLength == 15 && !ReadLength(in, end, literalLength)) {
+			return false;
+		}
+		if(literalLength > (size_t)(end - in) || literalLength > (size_t)(outEnd - out)) {
+			return false;
+		}
+		if(literalLength > 0) {
+			memcpy(out, in, literalLength);
+			in += literalLength;
+			out += literalLength;
+		}
+
+		if(in == end) {
+			//Last sequence has no match
+			break;
+		}
+
+		if(end - in < 2) {
+			return false;
+		}
+		size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+		if(offset == 0 || offset > (size_t)(out - output)) {
+			return false;
+		}
+
+		size_t matchLength = token & 0x0F;
+		if(matchLength == 15 && !ReadLength(in, end, matchLength)) {
+			return false;
+		}
+		matchLength += MinMatch;
+		if(matchLength > (size_t)(outEnd - out)) {
+			return false;
+		}
+
+		const uint8_t* ref = out - offset;
+		if(offset >= matchLength) {
+			memcpy(out, ref, matchLength);
+			out += matchLength;
+		} else if(offset == 1) {
+			//Run of the same byte
+			memset(out, *ref, matchLength);
+			out += matchLength;
+		} else {
+			//Overlapping match (repeated pattern), copy byte by byte
+			for(size_t i = 0; i < matchLength; i++) {
+				*out++ = *ref++;
+			}
+		}
+	}
+
+	return out == outEnd;
+}
+
+#if _DEBUG
+#include <assert.h>
+void LzCodec::RunTests()
+{
+	//Round trip tests for the edge cases of the format, run once in debug builds
+	auto test = [](const vector<uint8_t>& data) {
+		vector<uint8_t> compressed(GetMaxCompressedSize(data.size()));
+		size_t compressedSize = Compress(data.data(), data.size(), compressed.data());
+		assert(compressedSize <= compressed.size());
+
+		vector<uint8_t> output(data.size());
+		bool result = Decompress(compressed.data(), compressedSize, output.data(), output.size());
+		assert(result);
+		assert(output == data);
+
+		//Corrupted sizes must be rejected
+		if(compressedSize > 0) {
+			output.resize(data.size() + 1);
+			result = Decompress(compressed.data(), compressedSize, output.data(), output.size());
+			assert(!result);
+		}
+	};
+
+	uint32_t seed = 0x12345678;
+	auto randomBytes = [&](size_t size) {
+		vector<uint8_t> data(size);
+		for(uint8_t& value : data) {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			value = (uint8_t)seed;
+		}
+		return data;
+	};
+
+	//Empty & tiny inputs (shorter than a match + the last literals)
+	for(size_t i = 0; i <= 16; i++) {
+		test(vector<uint8_t>(i, 0));
+		test(randomBytes(i));
+	}
+
+	//Incompressible data
+	test(randomBytes(100000));
+
+	//Highly repetitive data (long matches & lengths that need several extra bytes)
+	test(vector<uint8_t>(300000, 0xAB));
+	vector<uint8_t> pattern;
+	for(int i = 0; i < 100000; i++) {
+		pattern.push_back((uint8_t)(i % 7));
+	}
+	test(pattern);
+
+	//Repeats that are further apart than the max match offset (64KB)
+	vector<uint8_t> block = randomBytes(70000);
+	vector<uint8_t> repeated = block;
+	repeated.insert(repeated.end(), block.begin(), block.end());
+	test(repeated);
+
+	//Mix of compressible and incompressible data
+	vector<uint8_t> mixed = randomBytes(30000);
+	mixed.resize(100000, 0);
+	vector<uint8_t> tail = randomBytes(40000);
+	mixed.insert(mixed.end(), tail.begin(), tail.end());
+	test(mixed);
+}
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+#include "pch.h"
+
+//Fast LZ77 codec (LZ4 block format), much faster than deflate at the cost of a lower compression ratio.
+//Used for data that is compressed/decompressed very often (e.g rewind history)
+class LzCodec
+{
+private:
+	static constexpr uint32_t MinMatch = 4;
+	static constexpr uint32_t LastLiterals = 5;
+	static constexpr uint32_t MatchSearchLimit = 12;
+	static constexpr uint32_t MaxOffset = 0xFFFF;
+
+	static void WriteLength(uint8_t*& out, size_t length);
+
+public:
+	static size_t GetMaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+	//Compresses the data into output, which must be at least GetMaxCompressedSize(size) bytes, and returns the compressed size
+	static size_t Compress(const uint8_t* data, size_t size, uint8_t* output);
+
+	//Returns false if the data is corrupted or doesn't decompress to exactly outputSize bytes
+	static bool Decompress(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize);
+
+#if _DEBUG
+	static void RunTests();
+#endif
+};
@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "RowBandThreadPool.h"
+
+RowBandThreadPool& RowBandThreadPool::GetInstance()
+{
+	//Never destroyed: the workers are waiting for work and are ended along with the process
+	//(joining them while the process/library is being unloaded can deadlock)
+	static RowBandThreadPool* instance = new RowBandThreadPool();
+	return *instance;
+}
+
+void RowBandThreadPool::StartThreads()
+{
+	//Keep 1 core for the emulation thread, the calling thread processes a band too
+	uint32_t coreCount = std::thread::hardware_concurrency();
+	uint32_t workerCount = std::min<uint32_t>(coreCount > 2 ? coreCount - 2 : 0, 7);
+	for(uint32_t i = 0; i < workerCount; i++) {
+		_threads.emplace_back(&RowBandThreadPool::WorkerLoop, this);
+	}
+	_threadsStarted = true;
+}
+
+void RowBandThreadPool::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while(true) {
+		_workSignal.wait(lock, [&] { return !_jobs.empty(); });
+		ProcessBand(*_jobs.front(), lock);
+	}
+}
+
+bool RowBandThreadPool::ProcessBand(Job& job, std::unique_lock<std::mutex>& lock)
+{
+	//Called with the lock held, the lock is released while the band is processed
+	if(job.NextBand >= job.BandCount) {
+		return false;
+	}
+
+	uint32_t band = job.NextBand++;
+	if(job.NextBand == job.BandCount) {
+		//All bands have been picked up, the job's thread waits for them to complete
+		_jobs.erase(std::find(_jobs.begin(), _jobs.end(), &job));
+	}
+
+	lock.unlock();
+	uint32_t startRow = band * job.BandSize;
+	(*job.Func)(startRow, std::min(startRow + job.BandSize, job.RowCount));
+	lock.lock();
+
+	job.CompletedBands++;
+	if(job.CompletedBands == job.BandCount) {
+		_doneSignal.notify_all();
+	}
+	return true;
+}
+
+void RowBandThreadPool::Run(uint32_t rowCount, uint32_t minBandSize, const BandFunc& func)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if(!_threadsStarted && rowCount >= minBandSize * 2) {
+		StartThreads();
+	}
+
+	uint32_t bandCount = std::min<uint32_t>((uint32_t)_threads.size() + 1, rowCount / std::max<uint32_t>(minBandSize, 1));
+	if(bandCount <= 1) {
+		lock.unlock();
+		func(0, rowCount);
+		return;
+	}
+
+	uint32_t bandSize = (rowCount + bandCount - 1) / bandCount;
+	bandCount = (rowCount + bandSize - 1) / bandSize;
+
+	Job job = { &func, rowCount, bandSize, bandCount, 0, 0 };
+	_jobs.push_back(&job);
+	_workSignal.notify_all();
+
+	//Process this job's bands until they have all been picked up, then wait for the workers to finish theirs
+	while(ProcessBand(job, lock)) {
+	}
+	_doneSignal.wait(lock, [&] { return job.CompletedBands == job.BandCount; });
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "pch.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//Thread pool used to process images in parallel: the rows are split into horizontal bands,
+//which are processed by the worker threads and the calling thread at the same time.
+//A single pool is shared by all video filters (of all emulator instances) - each Run() call queues
+//its bands as a job, and the workers process the bands of every queued job.
+//The worker threads are only started the first time a frame is large enough to be split.
+class RowBandThreadPool
+{
+public:
+	//Called with the [startRow, endRow) range of each band
+	typedef std::function<void(uint32_t startRow, uint32_t endRow)> BandFunc;
+
+private:
+	struct Job
+	{
+		const BandFunc* Func;
+		uint32_t RowCount;
+		uint32_t BandSize;
+		uint32_t BandCount;
+		uint32_t NextBand;
+		uint32_t CompletedBands;
+	};
+
+	vector<std::thread> _threads;
+	bool _threadsStarted = false;
+	std::mutex _mutex;
+	std::condition_variable _workSignal;
+	std::condition_variable _doneSignal;
+
+	//Jobs that still have bands that haven't been picked up by a thread
+	vector<Job*> _jobs;
+
+	RowBandThreadPool() {}
+
+	void StartThreads();
+	void WorkerLoop();
+	bool ProcessBand(Job& job, std::unique_lock<std::mutex>& lock);
+
+public:
+	static RowBandThreadPool& GetInstance();
+
+	//Runs func over [0, rowCount), split into bands of at least minBandSize rows, and returns once every band is done
+	//Bands must not write to memory used by other bands
+	void Run(uint32_t rowCount, uint32_t minBandSize, const BandFunc& func);
+};
@@ -2,7 +2,7 @@
 #include <algorithm>
 #include "Serializer.h"
 #include "ISerializable.h"
-#include "miniz.h"
+#include "CompressionHelper.h"
 
 Serializer::Serializer(uint32_t version, bool forSave, SerializeFormat format)
 {
@@ -14,10 +14,49 @@ Serializer::Serializer(uint32_t version, bool forSave, SerializeFormat format)
 			case SerializeFormat::Binary: _data.reserve(0x50000); break;
 			case SerializeFormat::Map: _mapValues.reserve(500); break;
 			case SerializeFormat::Text: _values.reserve(500); break;
+			case SerializeFormat::Raw:
+				_data.reserve(0x50000);
+				_data.resize(RawHeaderSize, 0);
+				break;
 		}
 	}
 }
 
+vector<uint8_t>& Serializer::GetData()
+{
+	UpdateRawHeader();
+	return _data;
+}
+
+void Serializer::ResetPosition()
+{
+	//Allows the loaded data to be streamed multiple times (used by in-memory snapshots)
+	_usedKeys.clear();
+	_rawPosition = RawHeaderSize;
+	_schemaHash = SchemaHashSeed;
+	_rawError = _data.size() < RawHeaderSize;
+}
+
+bool Serializer::ResetRaw(bool forSave)
+{
+	if(_format != SerializeFormat::Raw) {
+		return false;
+	}
+
+	if(forSave) {
+		_saving = true;
+		_data.resize(RawHeaderSize);
+		_usedKeys.clear();
+		_schemaHash = SchemaHashSeed;
+		_rawError = false;
+		return true;
+	} else {
+		UpdateRawHeader();
+		_saving = false;
+		return ParseRawHeader();
+	}
+}
+
 void Serializer::AddKeyPrefix(string prefix)
 {
 	vector<string> keys;
@@ -73,27 +112,25 @@ bool Serializer::LoadFrom(istream &file)
 
 	char value = 0;
 	file.get(value);
-	bool isCompressed = value == 1;
+	CompressionType compressionType = (CompressionType)value;
 
-	if(isCompressed) {
+	if(compressionType != CompressionType::None) {
 		uint32_t decompressedSize;
 		file.read((char*)&decompressedSize, sizeof(decompressedSize));
 
 		uint32_t compressedSize;
 		file.read((char*)&compressedSize, sizeof(compressedSize));
 
-		if(decompressedSize >= 1024 * 1024 * 10 || compressedSize >= 1024 * 1024 * 10) {
-			//Limit to 10mb the data's size
+		if(decompressedSize >= CompressionHelper::MaxSize || compressedSize >= CompressionHelper::MaxSize) {
 			return false;
 		}
 
-		vector<uint8_t> compressedData(compressedSize, 0);
+		//Reuse the same buffer for the compressed data of all states loaded by this thread
+		static thread_local vector<uint8_t> compressedData;
+		compressedData.resize(compressedSize);
 		file.read((char*)compressedData.data(), compressedSize);
 
-		_data = vector<uint8_t>(decompressedSize, 0);
-
-		unsigned long decompSize = decompressedSize;
-		if(uncompress(_data.data(), &decompSize, compressedData.data(), (unsigned long)compressedData.size()) != MZ_OK) {
+		if(!CompressionHelper::DecompressBlock(compressedData.data(), compressedSize, compressionType, _data, decompressedSize)) {
 			return false;
 		}
 	} else {
@@ -106,6 +143,50 @@ bool Serializer::LoadFrom(istream &file)
 		file.read((char*)_data.data(), stateSize);
 	}
 
+	return ParseData();
+}
+
+bool Serializer::LoadFrom(vector<uint8_t>&& data)
+{
+	//Loads uncompressed binary data (e.g the data produced by another Serializer's GetData)
+	if(_saving || (_format != SerializeFormat::Binary && _format != SerializeFormat::Raw)) {
+		return false;
+	}
+
+	_data = std::move(data);
+	return ParseData();
+}
+
+bool Serializer::ParseData()
+{
+	return _format == SerializeFormat::Raw ? ParseRawHeader() : ParseBinaryData();
+}
+
+bool Serializer::ParseRawHeader()
+{
+	if(_data.size() < RawHeaderSize || memcmp(_data.data(), RawHeaderTag, sizeof(RawHeaderTag)) != 0) {
+		_rawError = true;
+		return false;
+	}
+
+	memcpy(&_savedSchemaHash, _data.data() + sizeof(RawHeaderTag), sizeof(_savedSchemaHash));
+	ResetPosition();
+	return true;
+}
+
+void Serializer::UpdateRawHeader()
+{
+	if(_saving && _format == SerializeFormat::Raw) {
+		//The header's first byte is not a valid key character, so the binary format parser rejects raw data
+		memcpy(_data.data(), RawHeaderTag, sizeof(RawHeaderTag));
+		memcpy(_data.data() + sizeof(RawHeaderTag), &_schemaHash, sizeof(_schemaHash));
+	}
+}
+
+bool Serializer::ParseBinaryData()
+{
+	_values.clear();
+
 	uint32_t size = (uint32_t)_data.size();
 	uint32_t i = 0;
 	string key;
@@ -204,25 +285,24 @@ bool Serializer::LoadFromTextFormat(istream& file)
 	return true;
 }
 
-void Serializer::SaveTo(ostream& file, int compressionLevel)
+void Serializer::SaveTo(ostream& file, int compressionLevel, CompressionType compressionType)
 {
 	if(_format == SerializeFormat::Text) {
 		file.write((char*)_data.data(), _data.size());
 	} else {
-		bool isCompressed = compressionLevel > 0;
-		file.put((char)isCompressed);
-
-		if(isCompressed) {
-			unsigned long compressedSize = compressBound((unsigned long)_data.size());
-			uint8_t* compressedData = new uint8_t[compressedSize];
-			compress2(compressedData, &compressedSize, (unsigned char*)_data.data(), (unsigned long)_data.size(), compressionLevel);
-
-			uint32_t size = (uint32_t)compressedSize;
-			uint32_t originalSize = (uint32_t)_data.size();
-			file.write((char*)&originalSize, sizeof(uint32_t));
-			file.write((char*)&size, sizeof(uint32_t));
-			file.write((char*)compressedData, compressedSize);
-			delete[] compressedData;
+		UpdateRawHeader();
+
+		if(compressionLevel <= 0) {
+			compressionType = CompressionType::None;
+		}
+		file.put((char)compressionType);
+
+		if(compressionType != CompressionType::None) {
+			//Reuse the same buffer for the compressed data of all states saved by this thread
+			static thread_local vector<uint8_t> compressedData;
+			compressedData.clear();
+			CompressionHelper::CompressBlock(_data.data(), (uint32_t)_data.size(), compressionType, compressionLevel, compressedData);
+			file.write((char*)compressedData.data(), compressedData.size());
 		} else {
 			file.write((char*)_data.data(), _data.size());
 		}
@@ -269,12 +349,22 @@ string Serializer::NormalizeName(const char* name, int index)
 
 void Serializer::PushNamePrefix(const char* name, int index)
 {
+	if(_format == SerializeFormat::Raw) {
+		UpdateSchemaHash(name, (uint32_t)index, 0);
+		return;
+	}
+
 	_prefixes.push_back(NormalizeName(name, index));
 	UpdatePrefix();
 }
 
 void Serializer::PopNamePrefix()
 {
+	if(_format == SerializeFormat::Raw) {
+		UpdateSchemaHash("}", 0, 0);
+		return;
+	}
+
 	_prefixes.pop_back();
 	UpdatePrefix();
 }
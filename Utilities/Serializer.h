@@ -5,6 +5,7 @@
 #include "Utilities/FastString.h"
 #include "Utilities/magic_enum.hpp"
 #include "Utilities/safe_ptr.h"
+#include "Utilities/CompressionHelper.h"
 
 class Serializer;
 
@@ -66,7 +67,12 @@ enum class SerializeFormat
 {
 	Binary,
 	Text,
-	Map
+	Map,
+
+	//Key-less binary format: values are written back to back in the order they are streamed, without
+	//any key or size (except for vectors/strings), and loaded back in the same order. The layout is
+	//validated using a hash of the streamed names. Only usable to reload a state in the same build.
+	Raw
 };
 
 class Serializer
@@ -86,8 +92,22 @@ private:
 	bool _saving = false;
 	SerializeFormat _format = SerializeFormat::Binary;
 
+	//Used by raw format
+	static constexpr uint8_t RawHeaderTag[4] = { 0x01, 'R', 'A', 'W' };
+	static constexpr uint32_t RawHeaderSize = sizeof(RawHeaderTag) + sizeof(uint64_t);
+	uint32_t _rawPosition = 0;
+	static constexpr uint64_t SchemaHashSeed = 0xCBF29CE484222325; //FNV-1a offset basis
+
+	uint64_t _schemaHash = SchemaHashSeed;
+	uint64_t _savedSchemaHash = 0;
+	bool _rawError = false;
+
 private:
 	bool LoadFromTextFormat(istream& file);
+	bool ParseBinaryData();
+	bool ParseRawHeader();
+	bool ParseData();
+	void UpdateRawHeader();
 	string NormalizeName(const char* name, int index);
 	void UpdatePrefix();
 
@@ -203,6 +223,50 @@ private:
 		}
 	}
 
+	__forceinline void UpdateSchemaHash(const char* name, uint32_t value, uint32_t valueSize)
+	{
+		//FNV-1a hash of the names/indexes/sizes of the streamed values, computed without building any key string
+		constexpr uint64_t prime = 0x100000001B3;
+		for(const char* c = name; *c; c++) {
+			_schemaHash = (_schemaHash ^ (uint8_t)*c) * prime;
+		}
+		_schemaHash = (_schemaHash ^ value) * prime;
+		_schemaHash = (_schemaHash ^ valueSize) * prime;
+	}
+
+	__forceinline void WriteRaw(const void* src, uint32_t size)
+	{
+		_data.insert(_data.end(), (uint8_t*)src, (uint8_t*)src + size);
+	}
+
+	__forceinline bool ReadRaw(void* dst, uint32_t size)
+	{
+		if(_rawError || (uint64_t)_rawPosition + size > _data.size()) {
+			_rawError = true;
+			return false;
+		}
+		memcpy(dst, _data.data() + _rawPosition, size);
+		_rawPosition += size;
+		return true;
+	}
+
+	template<typename T> void StreamRawVector(T& values, const char* name, int index)
+	{
+		UpdateSchemaHash(name, (uint32_t)index, (uint32_t)sizeof(values[0]));
+		uint32_t elementCount = (uint32_t)values.size();
+		if(_saving) {
+			WriteRaw(&elementCount, sizeof(elementCount));
+			WriteRaw(values.data(), elementCount * sizeof(values[0]));
+		} else if(ReadRaw(&elementCount, sizeof(elementCount))) {
+			if((uint64_t)elementCount * sizeof(values[0]) > _data.size() - _rawPosition) {
+				_rawError = true;
+				return;
+			}
+			values.resize(elementCount);
+			ReadRaw(values.data(), elementCount * sizeof(values[0]));
+		}
+	}
+
 	__forceinline void CheckDuplicateKey(string& key)
 	{
 #ifndef MESENRELEASE
@@ -221,7 +285,18 @@ public:
 	SerializeFormat GetFormat() { return _format; }
 	unordered_map<string, SerializeMapValue>& GetMapValues() { return _mapValues; }
 
-	bool IsValid() { return _values.size() > 0; }
+	bool IsValid() { return _format == SerializeFormat::Raw ? (!_rawError && _data.size() >= RawHeaderSize) : _values.size() > 0; }
+	vector<uint8_t>& GetData();
+	void ResetPosition();
+	//For raw format: switches between saving a new state and loading the state that was just saved,
+	//reusing the data buffer's memory (avoids reallocating it when a state is saved/loaded every frame)
+	bool ResetRaw(bool forSave);
+
+	//For raw format: hash of the names streamed so far (when saving) or hash stored in the data (when loading)
+	uint64_t GetSchemaHash() { return _saving ? _schemaHash : _savedSchemaHash; }
+	//For raw format: true when the data was entirely consumed and matched the layout it was saved with
+	bool IsRawLoadComplete() { return !_rawError && _rawPosition == _data.size() && _schemaHash == _savedSchemaHash; }
+
 	void AddKeyPrefix(string prefix);
 	void RemoveKeyPrefix(string prefix);
 	void RemoveKeys(vector<string>& keys);
@@ -241,6 +316,13 @@ public:
 		
 		if constexpr(std::is_base_of<ISerializable, T>::value) {
 			Stream((ISerializable&)value, name, index);
+		} else if(_format == SerializeFormat::Raw) {
+			UpdateSchemaHash(name, (uint32_t)index, (uint32_t)sizeof(T));
+			if(_saving) {
+				WriteRaw(&value, sizeof(T));
+			} else {
+				ReadRaw(&value, sizeof(T));
+			}
 		} else {
 			string key = GetKey(name, index);
 
@@ -262,6 +344,7 @@ public:
 
 					case SerializeFormat::Text: WriteTextFormat(key, value); break;
 					case SerializeFormat::Map: WriteMapFormat(key, value); break;
+					case SerializeFormat::Raw: break;
 				}
 			} else {
 				switch(_format) {
@@ -295,6 +378,9 @@ public:
 					case SerializeFormat::Map:
 						ReadMapFormat(key, value);
 						break;
+
+					case SerializeFormat::Raw:
+						break;
 				}
 			}
 		}
@@ -343,6 +429,14 @@ public:
 	{
 		if(_format == SerializeFormat::Map) {
 			return;
+		} else if(_format == SerializeFormat::Raw) {
+			UpdateSchemaHash(name, elementCount, (uint32_t)sizeof(T));
+			if(_saving) {
+				WriteRaw(arrayValues, elementCount * sizeof(T));
+			} else {
+				ReadRaw(arrayValues, elementCount * sizeof(T));
+			}
+			return;
 		}
 
 		string key = GetKey(name, -1);
@@ -392,6 +486,9 @@ public:
 	{
 		if(_format == SerializeFormat::Map) {
 			return;
+		} else if(_format == SerializeFormat::Raw) {
+			StreamRawVector(values, name, index);
+			return;
 		}
 
 		string key = GetKey(name, index);
@@ -431,13 +528,19 @@ public:
 
 	void PushNamePrefix(const char* name, int index = -1);
 	void PopNamePrefix();
-	void SaveTo(ostream &file, int compressionLevel = 1);
+	void SaveTo(ostream &file, int compressionLevel = 1, CompressionType compressionType = CompressionType::Deflate);
 	bool LoadFrom(istream& file);
+	bool LoadFrom(vector<uint8_t>&& data);
 	void LoadFromMap(unordered_map<string, SerializeMapValue>& map);
 };
 
 template<> inline void Serializer::Stream(string& value, const char* name, int index)
 {
+	if(_format == SerializeFormat::Raw) {
+		StreamRawVector(value, name, index);
+		return;
+	}
+
 	string key = GetKey(name, index);
 
 	CheckDuplicateKey(key);
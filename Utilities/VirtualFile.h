@@ -18,8 +18,6 @@ private:
 
 	void FromStream(std::istream &input, vector<uint8_t> &output);
 
-	void LoadFile();
-
 public:
 	static const std::initializer_list<string> RomExtensions;
 
@@ -43,6 +41,7 @@ public:
 	size_t GetSize();
 	bool CheckFileSignature(vector<string> signatures, bool loadArchives = false);
 	void InitChunks();
+	void LoadFile();
 
 	bool ReadFile(vector<uint8_t> &out);
 	bool ReadFile(std::stringstream &out);